@@ -843,7 +843,26 @@ gtk_css_tokenizer_read_escape (GtkCssTokenizer *tokenizer)
 static char *
 gtk_css_tokenizer_read_name (GtkCssTokenizer *tokenizer)
 {
-  GString *string = g_string_new (NULL);
+  const char *start = tokenizer->data;
+  const char *data = start;
+  gsize n_characters = 0;
+  GString *string;
+
+  /* Fast path: names without escapes are copied straight
+   * from the input, without going through a GString.
+   */
+  while (data < tokenizer->end && is_name (*data))
+    {
+      data = g_utf8_next_char (data);
+      n_characters++;
+    }
+  data = MIN (data, tokenizer->end);
+  gtk_css_tokenizer_consume (tokenizer, data - start, n_characters);
+
+  if (tokenizer->data == tokenizer->end || *tokenizer->data != '\\')
+    return g_strndup (start, data - start);
+
+  string = g_string_new_len (start, data - start);
 
   do {
       if (*tokenizer->data == '\\')
@@ -1153,11 +1172,37 @@ gtk_css_tokenizer_read_string (GtkCssTokenizer  *tokenizer,
                                GtkCssToken      *token,
                                GError          **error)
 {
-  GString *string = g_string_new (NULL);
+  const char *start, *data;
+  gsize n_characters = 0;
+  GString *string;
   char end = *tokenizer->data;
 
   gtk_css_tokenizer_consume_ascii (tokenizer);
 
+  /* Fast path: strings without escapes are copied straight
+   * from the input, without going through a GString.
+   */
+  start = data = tokenizer->data;
+  while (data < tokenizer->end && *data != end && *data != '\\' && !is_newline (*data))
+    {
+      data = g_utf8_next_char (data);
+      n_characters++;
+    }
+  data = MIN (data, tokenizer->end);
+  gtk_css_tokenizer_consume (tokenizer, data - start, n_characters);
+
+  if (tokenizer->data == tokenizer->end || *tokenizer->data == end)
+    {
+      if (tokenizer->data < tokenizer->end)
+        gtk_css_tokenizer_consume_ascii (tokenizer);
+
+      gtk_css_token_init (token, GTK_CSS_TOKEN_STRING, g_strndup (start, data - start));
+
+      return TRUE;
+    }
+
+  string = g_string_new_len (start, data - start);
+
   while (tokenizer->data < tokenizer->end)
     {
       if (*tokenizer->data == end)
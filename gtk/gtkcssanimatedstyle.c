@@ -152,6 +152,30 @@ gtk_css_take_value (GtkCssValue **variable,
   *variable = value;
 }
 
+static gboolean
+gtk_css_animated_style_value_is_unchanged (GtkCssStyle *style,
+                                           guint        id,
+                                           GtkCssValue *value)
+{
+  switch (id)
+    {
+    /* These follow the color when unset, so setting them
+     * is a change even if the value is the current color.
+     */
+    case GTK_CSS_PROPERTY_BORDER_TOP_COLOR:
+    case GTK_CSS_PROPERTY_BORDER_RIGHT_COLOR:
+    case GTK_CSS_PROPERTY_BORDER_BOTTOM_COLOR:
+    case GTK_CSS_PROPERTY_BORDER_LEFT_COLOR:
+    case GTK_CSS_PROPERTY_OUTLINE_COLOR:
+    case GTK_CSS_PROPERTY_CARET_COLOR:
+    case GTK_CSS_PROPERTY_SECONDARY_CARET_COLOR:
+    case GTK_CSS_PROPERTY_TEXT_DECORATION_COLOR:
+      return FALSE;
+    default:
+      return _gtk_css_value_equal (gtk_css_style_get_value (style, id), value);
+    }
+}
+
 void
 gtk_css_animated_style_set_animated_value (GtkCssAnimatedStyle *animated,
                                            guint                id,
@@ -162,6 +186,15 @@ gtk_css_animated_style_set_animated_value (GtkCssAnimatedStyle *animated,
   gtk_internal_return_if_fail (GTK_IS_CSS_ANIMATED_STYLE (style));
   gtk_internal_return_if_fail (value != NULL);
 
+  /* Many animated values don't change between keyframes or are the
+   * same as the static value, so avoid unsharing the values for them.
+   */
+  if (gtk_css_animated_style_value_is_unchanged (style, id, value))
+    {
+      gtk_css_value_unref (value);
+      return;
+    }
+
   switch (id)
     {
     case GTK_CSS_PROPERTY_COLOR:
@@ -522,6 +522,10 @@ _gtk_css_keyframes_get_value (GtkCssKeyframes *keyframes,
         }
     }
 
+  /* Nothing to interpolate, so avoid creating a new value */
+  if (_gtk_css_value_equal (start_value, end_value))
+    return _gtk_css_value_ref (start_value);
+
   progress = (progress - start_progress) / (end_progress - start_progress);
 
   result = _gtk_css_value_transition (start_value,
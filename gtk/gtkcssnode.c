@@ -128,6 +128,18 @@ static int invalidated_nodes;
 static int created_styles;
 static guint invalidated_nodes_counter;
 static guint created_styles_counter;
+static guint style_cache_hits_counter;
+static guint style_cache_misses_counter;
+static guint match_time_counter;
+static guint compute_time_counter;
+static guint style_cache_hits;
+static guint style_cache_misses;
+
+/* Statistics for the last call to gtk_css_node_validate() */
+static guint last_invalidated_nodes;
+static guint last_created_styles;
+static guint last_style_cache_hits;
+static guint last_style_cache_misses;
 
 static void
 gtk_css_node_set_invalid (GtkCssNode *node,
@@ -306,24 +318,22 @@ may_use_global_parent_cache (GtkCssNode *node)
 
 static GtkCssStyle *
 lookup_in_global_parent_cache (GtkCssNode                  *node,
-                               const GtkCssNodeDeclaration *decl)
+                               const GtkCssNodeDeclaration *decl,
+                               gboolean                     is_first,
+                               gboolean                     is_last)
 {
   GtkCssNode *parent;
 
   parent = node->parent;
 
-  if (parent == NULL ||
-      !may_use_global_parent_cache (node))
-    return NULL;
-
   if (parent->cache == NULL)
     return NULL;
 
   g_assert (node->cache == NULL);
   node->cache = gtk_css_node_style_cache_lookup (parent->cache,
                                                  decl,
-                                                 gtk_css_node_is_first_child (node),
-                                                 gtk_css_node_is_last_child (node));
+                                                 is_first,
+                                                 is_last);
   if (node->cache == NULL)
     return NULL;
 
@@ -333,6 +343,8 @@ lookup_in_global_parent_cache (GtkCssNode                  *node,
 static void
 store_in_global_parent_cache (GtkCssNode                  *node,
                               const GtkCssNodeDeclaration *decl,
+                              gboolean                     is_first,
+                              gboolean                     is_last,
                               GtkCssStyle                 *style)
 {
   GtkCssNode *parent;
@@ -341,17 +353,13 @@ store_in_global_parent_cache (GtkCssNode                  *node,
 
   parent = node->parent;
 
-  if (parent == NULL ||
-      !may_use_global_parent_cache (node))
-    return;
-
   if (parent->cache == NULL)
     parent->cache = gtk_css_node_style_cache_new (parent->style);
 
   node->cache = gtk_css_node_style_cache_insert (parent->cache,
                                                  (GtkCssNodeDeclaration *) decl,
-                                                 gtk_css_node_is_first_child (node),
-                                                 gtk_css_node_is_last_child (node),
+                                                 is_first,
+                                                 is_last,
                                                  style);
 }
 
@@ -363,12 +371,32 @@ gtk_css_node_create_style (GtkCssNode                   *cssnode,
   const GtkCssNodeDeclaration *decl;
   GtkCssStyle *style;
   GtkCssChange style_change;
+  gboolean use_cache, is_first, is_last;
 
   decl = gtk_css_node_get_declaration (cssnode);
 
-  style = lookup_in_global_parent_cache (cssnode, decl);
-  if (style)
-    return g_object_ref (style);
+  /* Finding the position walks over invisible siblings, so only do
+   * it once for both the lookup and the store.
+   */
+  use_cache = may_use_global_parent_cache (cssnode);
+  if (use_cache)
+    {
+      is_first = gtk_css_node_is_first_child (cssnode);
+      is_last = gtk_css_node_is_last_child (cssnode);
+
+      style = lookup_in_global_parent_cache (cssnode, decl, is_first, is_last);
+      if (style)
+        {
+          style_cache_hits++;
+          return g_object_ref (style);
+        }
+
+      style_cache_misses++;
+    }
+  else
+    {
+      is_first = is_last = FALSE;
+    }
 
   created_styles++;
 
@@ -387,7 +415,8 @@ gtk_css_node_create_style (GtkCssNode                   *cssnode,
                                             cssnode,
                                             style_change);
 
-  store_in_global_parent_cache (cssnode, decl, style);
+  if (use_cache)
+    store_in_global_parent_cache (cssnode, decl, is_first, is_last, style);
 
   return style;
 }
@@ -631,6 +660,10 @@ gtk_css_node_class_init (GtkCssNodeClass *klass)
     {
       invalidated_nodes_counter = gdk_profiler_define_int_counter ("invalidated-nodes", "CSS Node Invalidations");
       created_styles_counter = gdk_profiler_define_int_counter ("created-styles", "CSS Style Creations");
+      style_cache_hits_counter = gdk_profiler_define_int_counter ("style-cache-hits", "CSS Style Cache Hits");
+      style_cache_misses_counter = gdk_profiler_define_int_counter ("style-cache-misses", "CSS Style Cache Misses");
+      match_time_counter = gdk_profiler_define_int_counter ("css-match-time", "CSS Selector Matching Time (usec)");
+      compute_time_counter = gdk_profiler_define_int_counter ("css-compute-time", "CSS Value Computation Time (usec)");
     }
 }
 
@@ -948,6 +981,35 @@ gtk_css_node_needs_new_style (GtkCssNode *cssnode)
   return cssnode->style_is_invalid || cssnode->needs_propagation;
 }
 
+/* Adds a profiler mark for restyling a node, listing the changes
+ * that caused it and, if they were propagated from the parent, the
+ * parent node, so that the source of big restyles can be tracked down.
+ */
+static void
+gtk_css_node_add_restyle_mark (GtkCssNode *cssnode,
+                               gint64      before)
+{
+  GString *string;
+
+  string = g_string_new (NULL);
+  gtk_css_node_declaration_print (cssnode->decl, string);
+  g_string_append (string, ": ");
+  gtk_css_change_print (cssnode->pending_changes, string);
+
+  if (cssnode->parent &&
+      cssnode->pending_changes & (GTK_CSS_CHANGE_ANY_PARENT |
+                                  GTK_CSS_CHANGE_ANY_PARENT_SIBLING |
+                                  GTK_CSS_CHANGE_PARENT_STYLE))
+    {
+      g_string_append (string, " from ");
+      gtk_css_node_declaration_print (cssnode->parent->decl, string);
+    }
+
+  gdk_profiler_end_mark (before, "css restyle", string->str);
+
+  g_string_free (string, TRUE);
+}
+
 static void
 gtk_css_node_do_ensure_style (GtkCssNode                   *cssnode,
                               const GtkCountingBloomFilter *filter,
@@ -958,6 +1020,9 @@ gtk_css_node_do_ensure_style (GtkCssNode                   *cssnode,
   if (cssnode->style_is_invalid)
     {
       GtkCssStyle *new_style;
+      gint64 before G_GNUC_UNUSED;
+
+      before = GDK_PROFILER_CURRENT_TIME;
 
       g_clear_pointer (&cssnode->cache, gtk_css_node_style_cache_unref);
 
@@ -967,6 +1032,9 @@ gtk_css_node_do_ensure_style (GtkCssNode                   *cssnode,
                                                                   current_time,
                                                                   cssnode->style);
 
+      if (GDK_PROFILER_IS_RUNNING)
+        gtk_css_node_add_restyle_mark (cssnode, before);
+
       style_changed = gtk_css_node_set_style (cssnode, new_style);
       g_object_unref (new_style);
     }
@@ -1365,23 +1433,64 @@ gtk_css_node_validate (GtkCssNode *cssnode)
   GtkCountingBloomFilter filter = GTK_COUNTING_BLOOM_FILTER_INIT;
   gint64 timestamp;
   gint64 before G_GNUC_UNUSED;
+  guint hits, misses;
 
   before = GDK_PROFILER_CURRENT_TIME;
 
   g_assert (cssnode->parent == NULL);
 
   timestamp = gtk_css_node_get_timestamp (cssnode);
+  hits = style_cache_hits;
+  misses = style_cache_misses;
 
   gtk_css_node_validate_internal (cssnode, &filter, timestamp);
 
+  last_invalidated_nodes = invalidated_nodes;
+  last_created_styles = created_styles;
+  last_style_cache_hits = style_cache_hits - hits;
+  last_style_cache_misses = style_cache_misses - misses;
+
   if (GDK_PROFILER_IS_RUNNING)
     {
+      gint64 match_time, compute_time;
+
+      gtk_css_static_style_steal_timings (&match_time, &compute_time);
+
       gdk_profiler_end_mark (before,  "css validation", "");
       gdk_profiler_set_int_counter (invalidated_nodes_counter, invalidated_nodes);
       gdk_profiler_set_int_counter (created_styles_counter, created_styles);
-      invalidated_nodes = 0;
-      created_styles = 0;
+      gdk_profiler_set_int_counter (style_cache_hits_counter, last_style_cache_hits);
+      gdk_profiler_set_int_counter (style_cache_misses_counter, last_style_cache_misses);
+      gdk_profiler_set_int_counter (match_time_counter, match_time / 1000);
+      gdk_profiler_set_int_counter (compute_time_counter, compute_time / 1000);
     }
+
+  invalidated_nodes = 0;
+  created_styles = 0;
+}
+
+/* This is exported privately for use in GtkInspector.
+ */
+void
+gtk_css_node_get_style_cache_statistics (guint *hits,
+                                         guint *misses)
+{
+  *hits = style_cache_hits;
+  *misses = style_cache_misses;
+}
+
+/* This is exported privately for use in GtkInspector.
+ */
+void
+gtk_css_node_get_validation_statistics (guint *invalidated,
+                                        guint *created,
+                                        guint *hits,
+                                        guint *misses)
+{
+  *invalidated = last_invalidated_nodes;
+  *created = last_created_styles;
+  *hits = last_style_cache_hits;
+  *misses = last_style_cache_misses;
 }
 
 GtkStyleProvider *
@@ -152,6 +152,15 @@ void                    gtk_css_node_validate           (GtkCssNode            *
 
 GtkStyleProvider *      gtk_css_node_get_style_provider (GtkCssNode            *cssnode) G_GNUC_PURE;
 
+void                    gtk_css_node_get_style_cache_statistics
+                                                        (guint                 *hits,
+                                                         guint                 *misses);
+void                    gtk_css_node_get_validation_statistics
+                                                        (guint                 *invalidated,
+                                                         guint                 *created,
+                                                         guint                 *hits,
+                                                         guint                 *misses);
+
 void                    gtk_css_node_print              (GtkCssNode                *cssnode,
                                                          GtkStyleContextPrintFlags  flags,
                                                          GString                   *string,
@@ -162,6 +162,64 @@ gtk_css_node_style_cache_insert (GtkCssNodeStyleCache   *parent,
   return result;
 }
 
+static gboolean
+position_is_irrelevant (GtkCssStyle *style,
+                        gboolean     first_differs,
+                        gboolean     last_differs)
+{
+  GtkCssChange change;
+
+  change = gtk_css_static_style_get_change (GTK_CSS_STATIC_STYLE (style));
+
+  if (first_differs && (change & GTK_CSS_CHANGE_FIRST_CHILD))
+    return FALSE;
+
+  if (last_differs && (change & GTK_CSS_CHANGE_LAST_CHILD))
+    return FALSE;
+
+  return TRUE;
+}
+
+/* The first and last child usually look exactly like their siblings,
+ * so before giving up, check if a sibling at a different position has
+ * a style that doesn't depend on the position.
+ *
+ * We can share the style, but not the cache entry itself: it also
+ * holds the styles of the children, and their selectors might depend
+ * on the position of this node.
+ */
+static GtkCssNodeStyleCache *
+gtk_css_node_style_cache_lookup_position (GtkCssNodeStyleCache        *parent,
+                                          const GtkCssNodeDeclaration *decl,
+                                          gboolean                     is_first,
+                                          gboolean                     is_last)
+{
+  GtkCssNodeStyleCache *result;
+  guint i;
+
+  for (i = 1; i < 4; i++)
+    {
+      gboolean first_differs = (i & 0x2) != 0;
+      gboolean last_differs = (i & 0x1) != 0;
+
+      result = g_hash_table_lookup (parent->children,
+                                    PACK (decl,
+                                          first_differs ? !is_first : is_first,
+                                          last_differs ? !is_last : is_last));
+      if (result == NULL ||
+          !position_is_irrelevant (result->style, first_differs, last_differs))
+        continue;
+
+      return gtk_css_node_style_cache_insert (parent,
+                                              (GtkCssNodeDeclaration *) decl,
+                                              is_first,
+                                              is_last,
+                                              result->style);
+    }
+
+  return NULL;
+}
+
 GtkCssNodeStyleCache *
 gtk_css_node_style_cache_lookup (GtkCssNodeStyleCache        *parent,
                                  const GtkCssNodeDeclaration *decl,
@@ -174,9 +232,9 @@ gtk_css_node_style_cache_lookup (GtkCssNodeStyleCache        *parent,
     return NULL;
 
   result = g_hash_table_lookup (parent->children, PACK (decl, is_first, is_last));
-  if (result == NULL)
-    return NULL;
+  if (result)
+    return gtk_css_node_style_cache_ref (result);
 
-  return gtk_css_node_style_cache_ref (result);
+  return gtk_css_node_style_cache_lookup_position (parent, decl, is_first, is_last);
 }
 
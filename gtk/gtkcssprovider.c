@@ -131,6 +131,18 @@ struct _GtkCssProviderPrivate
   GtkCssSelectorTree *tree;
   GResource *resource;
   char *path;
+
+  /* Shared, already compiled stylesheet that is used instead of
+   * the fields above, see gtk_css_provider_get_rules().
+   */
+  GtkCssProvider *compiled;
+  guint cacheable : 1;
+
+  /* TRUE if the last load had no errors and no imports, so loading
+   * the same data again would give the same result.
+   */
+  guint self_contained : 1;
+  char *loaded_checksum;
 };
 
 enum {
@@ -140,6 +152,13 @@ enum {
 
 static gboolean gtk_keep_css_sections = FALSE;
 
+/* Resources can't change while the process is running, so stylesheets
+ * loaded from resource:// URIs (that is, the built-in themes and the
+ * ones applications ship) are only parsed and compiled into a selector
+ * tree once. Maps URI => GtkCssProvider holding the compiled rules.
+ */
+static GHashTable *compiled_stylesheets = NULL;
+
 static guint css_provider_signals[LAST_SIGNAL] = { 0 };
 
 static void gtk_css_provider_finalize (GObject *object);
@@ -307,6 +326,21 @@ gtk_css_ruleset_add (GtkCssRuleset       *ruleset,
     ruleset->styles[i].section = NULL;
 }
 
+/* Returns the private struct holding the rules for @css_provider.
+ * Everything reading rulesets, colors or keyframes must go through
+ * this, as they might live in a shared compiled stylesheet.
+ */
+static GtkCssProviderPrivate *
+gtk_css_provider_get_rules (GtkCssProvider *css_provider)
+{
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+
+  if (priv->compiled)
+    return gtk_css_provider_get_instance_private (priv->compiled);
+
+  return priv;
+}
+
 static void
 gtk_css_scanner_destroy (GtkCssScanner *scanner)
 {
@@ -321,6 +355,12 @@ gtk_css_style_provider_emit_error (GtkStyleProvider *provider,
                                    GtkCssSection    *section,
                                    const GError     *error)
 {
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (GTK_CSS_PROVIDER (provider));
+
+  /* Don't share stylesheets that need to report errors */
+  priv->cacheable = FALSE;
+  priv->self_contained = FALSE;
+
   g_signal_emit (provider, css_provider_signals[PARSING_ERROR], 0, section, error);
 }
 
@@ -404,7 +444,7 @@ verify_tree_match_results (GtkCssProvider        *provider,
                            GtkCssSelectorMatches *tree_rules)
 {
 #ifdef VERIFY_TREE
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_rules (provider);
   GtkCssRuleset *ruleset;
   gboolean should_match;
   int i, j;
@@ -440,7 +480,7 @@ gtk_css_style_provider_get_color (GtkStyleProvider *provider,
                                   const char       *name)
 {
   GtkCssProvider *css_provider = GTK_CSS_PROVIDER (provider);
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_rules (css_provider);
 
   return g_hash_table_lookup (priv->symbolic_colors, name);
 }
@@ -450,7 +490,7 @@ gtk_css_style_provider_get_keyframes (GtkStyleProvider *provider,
                                       const char       *name)
 {
   GtkCssProvider *css_provider = GTK_CSS_PROVIDER (provider);
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_rules (css_provider);
 
   return g_hash_table_lookup (priv->keyframes, name);
 }
@@ -463,7 +503,7 @@ gtk_css_style_provider_lookup (GtkStyleProvider             *provider,
                                GtkCssChange                 *change)
 {
   GtkCssProvider *css_provider = GTK_CSS_PROVIDER (provider);
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_rules (css_provider);
   GtkCssRuleset *ruleset;
   guint j;
   int i;
@@ -540,6 +580,8 @@ gtk_css_provider_finalize (GObject *object)
     }
 
   g_free (priv->path);
+  g_clear_object (&priv->compiled);
+  g_free (priv->loaded_checksum);
 
   G_OBJECT_CLASS (gtk_css_provider_parent_class)->finalize (object);
 }
@@ -602,6 +644,9 @@ gtk_css_provider_reset (GtkCssProvider *css_provider)
       priv->path = NULL;
     }
 
+  g_clear_object (&priv->compiled);
+  g_clear_pointer (&priv->loaded_checksum, g_free);
+
   g_hash_table_remove_all (priv->symbolic_colors);
   g_hash_table_remove_all (priv->keyframes);
 
@@ -672,6 +717,14 @@ parse_import (GtkCssScanner *scanner)
     }
   else
     {
+      GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (scanner->provider);
+
+      /* Only share stylesheets that can't change underneath us */
+      if (!g_file_has_uri_scheme (file, "resource"))
+        priv->cacheable = FALSE;
+
+      priv->self_contained = FALSE;
+
       gtk_css_provider_load_internal (scanner->provider,
                                       scanner,
                                       file,
@@ -1012,16 +1065,100 @@ gtk_css_provider_postprocess (GtkCssProvider *css_provider)
   gdk_profiler_end_mark (before, "create selector tree", NULL);
 }
 
+#define SWAP_POINTERS(a, b) G_STMT_START { \
+  gpointer tmp_ = (a); \
+  (a) = (b); \
+  (b) = tmp_; \
+} G_STMT_END
+
+static gboolean
+gtk_css_provider_load_compiled (GtkCssProvider *self,
+                                GFile          *file)
+{
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (self);
+  GtkCssProvider *compiled;
+  char *uri;
+
+  if (compiled_stylesheets == NULL)
+    return FALSE;
+
+  uri = g_file_get_uri (file);
+  compiled = g_hash_table_lookup (compiled_stylesheets, uri);
+  g_free (uri);
+
+  if (compiled == NULL)
+    return FALSE;
+
+  priv->compiled = g_object_ref (compiled);
+
+  return TRUE;
+}
+
+/* Moves the freshly compiled rules of @self into a new provider that
+ * is kept in the cache and shared with all later loads of @file.
+ */
+static void
+gtk_css_provider_save_compiled (GtkCssProvider *self,
+                                GFile          *file)
+{
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (self);
+  GtkCssProviderPrivate *compiled_priv;
+  GtkCssProvider *compiled;
+
+  compiled = g_object_new (GTK_TYPE_CSS_PROVIDER, NULL);
+  compiled_priv = gtk_css_provider_get_instance_private (compiled);
+
+  /* The selector tree points into the rulesets array, which is
+   * fine as we only swap the GArray and not its contents.
+   */
+  SWAP_POINTERS (priv->symbolic_colors, compiled_priv->symbolic_colors);
+  SWAP_POINTERS (priv->keyframes, compiled_priv->keyframes);
+  SWAP_POINTERS (priv->rulesets, compiled_priv->rulesets);
+  SWAP_POINTERS (priv->tree, compiled_priv->tree);
+
+  if (compiled_stylesheets == NULL)
+    compiled_stylesheets = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                  g_free, g_object_unref);
+
+  g_hash_table_insert (compiled_stylesheets, g_file_get_uri (file), compiled);
+  priv->compiled = g_object_ref (compiled);
+}
+
 static void
 gtk_css_provider_load_internal (GtkCssProvider *self,
                                 GtkCssScanner  *parent,
                                 GFile          *file,
                                 GBytes         *bytes)
 {
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (self);
   gint64 before G_GNUC_UNUSED;
 
   before = GDK_PROFILER_CURRENT_TIME;
 
+  if (parent == NULL)
+    {
+      priv->self_contained = TRUE;
+
+      /* Sections point into the source file, so we can only
+       * share stylesheets if nobody is interested in them.
+       */
+      priv->cacheable = bytes == NULL &&
+                        file != NULL &&
+                        g_file_has_uri_scheme (file, "resource") &&
+                        !gtk_keep_css_sections;
+
+      if (priv->cacheable && gtk_css_provider_load_compiled (self, file))
+        {
+          if (GDK_PROFILER_IS_RUNNING)
+            {
+              char *uri = g_file_get_uri (file);
+              gdk_profiler_end_mark (before, "theme load (cached)", uri);
+              g_free (uri);
+            }
+          return;
+        }
+    }
+
   if (bytes == NULL)
     {
       GError *load_error = NULL;
@@ -1064,7 +1201,12 @@ gtk_css_provider_load_internal (GtkCssProvider *self,
       gtk_css_scanner_destroy (scanner);
 
       if (parent == NULL)
-        gtk_css_provider_postprocess (self);
+        {
+          gtk_css_provider_postprocess (self);
+
+          if (priv->cacheable)
+            gtk_css_provider_save_compiled (self, file);
+        }
 
       g_bytes_unref (bytes);
     }
@@ -1087,13 +1229,21 @@ gtk_css_provider_load_internal (GtkCssProvider *self,
  *
  * Loads @data into @css_provider, and by doing so clears any previously loaded
  * information.
+ *
+ * If @data is identical to the data of the previous call, and loading that
+ * data caused no parsing errors and used no `@import` rules, @css_provider
+ * is not reloaded and styles are not updated. To force a reload, for example
+ * because an imported file changed, load different data in between or use a
+ * new provider.
  **/
 void
 gtk_css_provider_load_from_data (GtkCssProvider  *css_provider,
                                  const char      *data,
                                  gssize           length)
 {
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
   GBytes *bytes;
+  char *checksum;
 
   g_return_if_fail (GTK_IS_CSS_PROVIDER (css_provider));
   g_return_if_fail (data != NULL);
@@ -1103,12 +1253,29 @@ gtk_css_provider_load_from_data (GtkCssProvider  *css_provider,
 
   bytes = g_bytes_new_static (data, length);
 
+  /* Applications tend to reload their CSS whenever something might
+   * have changed. Avoid restyling everything if nothing did.
+   */
+  checksum = g_compute_checksum_for_bytes (G_CHECKSUM_SHA256, bytes);
+  if (priv->loaded_checksum && priv->self_contained &&
+      strcmp (priv->loaded_checksum, checksum) == 0)
+    {
+      g_free (checksum);
+      g_bytes_unref (bytes);
+      return;
+    }
+
   gtk_css_provider_reset (css_provider);
 
   g_bytes_ref (bytes);
   gtk_css_provider_load_internal (css_provider, NULL, NULL, bytes);
   g_bytes_unref (bytes);
 
+  if (priv->self_contained)
+    priv->loaded_checksum = checksum;
+  else
+    g_free (checksum);
+
   gtk_style_provider_changed (GTK_STYLE_PROVIDER (css_provider));
 }
 
@@ -1506,7 +1673,7 @@ gtk_css_provider_print_keyframes (GHashTable *keyframes,
 char *
 gtk_css_provider_to_string (GtkCssProvider *provider)
 {
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_rules (provider);
   GString *str;
   guint i;
 
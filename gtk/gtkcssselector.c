@@ -126,6 +126,27 @@ struct _GtkCssSelectorTree
   gint32 matches_offset; /* pointers that we return as matches if selector matches */
 };
 
+/* The top level of the tree is a long list of siblings, most of them
+ * checking for a name, class or id. To avoid calling match_one() on
+ * all of them for every node, the builder puts an index in front of
+ * the tree that buckets those by the quark they check for.
+ */
+typedef struct {
+  GHashTable *names;    /* GQuark => GtkCssSelectorTree */
+  GHashTable *classes;
+  GHashTable *ids;
+  GPtrArray *others;    /* top level trees that need to be checked for every node */
+} GtkCssSelectorTreeIndex;
+
+#define GTK_CSS_SELECTOR_TREE_INDEX_SIZE \
+  (((sizeof (GtkCssSelectorTreeIndex) + sizeof (GtkCssSelectorTree) - 1) / sizeof (GtkCssSelectorTree)) * sizeof (GtkCssSelectorTree))
+
+static inline GtkCssSelectorTreeIndex *
+gtk_css_selector_tree_get_index (const GtkCssSelectorTree *tree)
+{
+  return (GtkCssSelectorTreeIndex *) ((guint8 *) tree - GTK_CSS_SELECTOR_TREE_INDEX_SIZE);
+}
+
 static gboolean
 gtk_css_selector_equal (const GtkCssSelector *a,
 			const GtkCssSelector *b)
@@ -150,26 +171,6 @@ gtk_css_selector_tree_get_matches (const GtkCssSelectorTree *tree)
   return (gpointer *) ((guint8 *)tree + tree->matches_offset);
 }
 
-static void
-gtk_css_selector_matches_insert_sorted (GtkCssSelectorMatches *matches,
-                                        gpointer               data)
-{
-  guint i;
-
-  for (i = 0; i < gtk_css_selector_matches_get_size (matches); i++)
-    {
-      gpointer elem = gtk_css_selector_matches_get (matches, i);
-
-      if (data == elem)
-        return;
-
-      if (data < elem)
-        break;
-    }
-
-  gtk_css_selector_matches_splice (matches, i, 0, (gpointer[1]) { data }, 1);
-}
-
 static inline gboolean
 gtk_css_selector_match_one (const GtkCssSelector *selector,
                             GtkCssNode           *node)
@@ -1886,7 +1887,7 @@ gtk_css_selector_tree_found_match (const GtkCssSelectorTree  *tree,
     return;
 
   for (i = 0; matches[i] != NULL; i++)
-    gtk_css_selector_matches_insert_sorted (results, matches[i]);
+    gtk_css_selector_matches_append (results, matches[i]);
 }
 
 static gboolean
@@ -1927,20 +1928,132 @@ gtk_css_selector_tree_match (const GtkCssSelectorTree      *tree,
   return TRUE;
 }
 
+static int
+compare_matches (gconstpointer a,
+                 gconstpointer b)
+{
+  gpointer match_a = *(gpointer *) a;
+  gpointer match_b = *(gpointer *) b;
+
+  if (match_a < match_b)
+    return -1;
+  else if (match_a > match_b)
+    return 1;
+  else
+    return 0;
+}
+
+/* Matches are collected unsorted, as the same rule can be found
+ * multiple times via different ancestors. Sort them once at the
+ * end and drop the duplicates.
+ */
+static void
+gtk_css_selector_matches_sort_unique (GtkCssSelectorMatches *matches)
+{
+  gpointer *data;
+  gsize i, j, size;
+
+  size = gtk_css_selector_matches_get_size (matches);
+  if (size < 2)
+    return;
+
+  data = gtk_css_selector_matches_get_data (matches);
+  qsort (data, size, sizeof (gpointer), compare_matches);
+
+  for (i = 1, j = 1; i < size; i++)
+    {
+      if (data[i] != data[j - 1])
+        data[j++] = data[i];
+    }
+
+  gtk_css_selector_matches_set_size (matches, j);
+}
+
+/* Collects the top level trees that may match @node */
+static void
+gtk_css_selector_tree_get_candidates (const GtkCssSelectorTree *tree,
+                                      GtkCssNode               *node,
+                                      GtkCssSelectorMatches    *candidates)
+{
+  GtkCssSelectorTreeIndex *index = gtk_css_selector_tree_get_index (tree);
+  const GQuark *classes;
+  gpointer candidate;
+  guint i, n_classes;
+
+  gtk_css_selector_matches_splice (candidates, 0, 0, index->others->pdata, index->others->len);
+
+  candidate = g_hash_table_lookup (index->names, GUINT_TO_POINTER (gtk_css_node_get_name (node)));
+  if (candidate)
+    gtk_css_selector_matches_append (candidates, candidate);
+
+  candidate = g_hash_table_lookup (index->ids, GUINT_TO_POINTER (gtk_css_node_get_id (node)));
+  if (candidate)
+    gtk_css_selector_matches_append (candidates, candidate);
+
+  classes = gtk_css_node_declaration_get_classes (gtk_css_node_get_declaration (node), &n_classes);
+  for (i = 0; i < n_classes; i++)
+    {
+      candidate = g_hash_table_lookup (index->classes, GUINT_TO_POINTER (classes[i]));
+      if (candidate)
+        gtk_css_selector_matches_append (candidates, candidate);
+    }
+}
+
+#ifdef G_ENABLE_CONSISTENCY_CHECKS
+/* Checks that going through the index finds the same matches as
+ * trying every top level tree.
+ */
+static void
+gtk_css_selector_tree_check_matches (const GtkCssSelectorTree     *tree,
+                                     const GtkCountingBloomFilter *filter,
+                                     GtkCssNode                   *node,
+                                     GtkCssSelectorMatches        *tree_rules)
+{
+  GtkCssSelectorMatches linear;
+  const GtkCssSelectorTree *iter;
+  guint i;
+
+  gtk_css_selector_matches_init (&linear);
+
+  for (iter = tree; iter != NULL; iter = gtk_css_selector_tree_get_sibling (iter))
+    gtk_css_selector_tree_match (iter, filter, FALSE, node, &linear);
+
+  gtk_css_selector_matches_sort_unique (&linear);
+
+  g_assert_cmpuint (gtk_css_selector_matches_get_size (&linear), ==, gtk_css_selector_matches_get_size (tree_rules));
+  for (i = 0; i < gtk_css_selector_matches_get_size (&linear); i++)
+    g_assert (gtk_css_selector_matches_get (&linear, i) == gtk_css_selector_matches_get (tree_rules, i));
+
+  gtk_css_selector_matches_clear (&linear);
+}
+#else
+#define gtk_css_selector_tree_check_matches(tree, filter, node, tree_rules)
+#endif /* G_ENABLE_CONSISTENCY_CHECKS */
+
 void
 _gtk_css_selector_tree_match_all (const GtkCssSelectorTree     *tree,
                                   const GtkCountingBloomFilter *filter,
                                   GtkCssNode                   *node,
                                   GtkCssSelectorMatches        *out_tree_rules)
 {
-  const GtkCssSelectorTree *iter;
+  GtkCssSelectorMatches candidates;
+  guint i;
 
-  for (iter = tree;
-       iter != NULL;
-       iter = gtk_css_selector_tree_get_sibling (iter))
-    {
-      gtk_css_selector_tree_match (iter, filter, FALSE, node, out_tree_rules);
-    }
+  if (tree == NULL)
+    return;
+
+  gtk_css_selector_matches_init (&candidates);
+  gtk_css_selector_tree_get_candidates (tree, node, &candidates);
+
+  for (i = 0; i < gtk_css_selector_matches_get_size (&candidates); i++)
+    gtk_css_selector_tree_match (gtk_css_selector_matches_get (&candidates, i),
+                                 filter, FALSE, node, out_tree_rules);
+
+  gtk_css_selector_matches_clear (&candidates);
+
+  gtk_css_selector_matches_sort_unique (out_tree_rules);
+
+  gtk_css_selector_tree_check_matches (tree, filter, node, out_tree_rules);
 }
 
 gboolean
@@ -1954,11 +2067,35 @@ gtk_css_selector_tree_get_change_all (const GtkCssSelectorTree     *tree,
                                       const GtkCountingBloomFilter *filter,
 				      GtkCssNode                   *node)
 {
+  const GtkCssSelectorTree *iter;
   GtkCssChange change = 0;
 
-  for (; tree != NULL;
-       tree = gtk_css_selector_tree_get_sibling (tree))
-    change |= gtk_css_selector_tree_get_change (tree, filter, node, FALSE);
+  if (tree == NULL)
+    return 0;
+
+  /* The top level trees for other names, ids and classes
+   * don't match the node, so they don't contribute a change.
+   */
+  if (node)
+    {
+      GtkCssSelectorMatches candidates;
+      guint i;
+
+      gtk_css_selector_matches_init (&candidates);
+      gtk_css_selector_tree_get_candidates (tree, node, &candidates);
+
+      for (i = 0; i < gtk_css_selector_matches_get_size (&candidates); i++)
+        change |= gtk_css_selector_tree_get_change (gtk_css_selector_matches_get (&candidates, i),
+                                                    filter, node, FALSE);
+
+      gtk_css_selector_matches_clear (&candidates);
+    }
+  else
+    {
+      for (iter = tree; iter != NULL;
+           iter = gtk_css_selector_tree_get_sibling (iter))
+        change |= gtk_css_selector_tree_get_change (iter, filter, node, FALSE);
+    }
 
   /* Never return reserved bit set */
   return change & ~GTK_CSS_CHANGE_RESERVED_BIT;
@@ -2070,10 +2207,18 @@ _gtk_css_selector_tree_match_print (const GtkCssSelectorTree *tree,
 void
 _gtk_css_selector_tree_free (GtkCssSelectorTree *tree)
 {
+  GtkCssSelectorTreeIndex *index;
+
   if (tree == NULL)
     return;
 
-  g_free (tree);
+  index = gtk_css_selector_tree_get_index (tree);
+  g_hash_table_unref (index->names);
+  g_hash_table_unref (index->classes);
+  g_hash_table_unref (index->ids);
+  g_ptr_array_unref (index->others);
+
+  g_free (index);
 }
 
 
@@ -2269,6 +2414,33 @@ fixup_offsets (GtkCssSelectorTree *tree, guint8 *data)
     }
 }
 
+static void
+gtk_css_selector_tree_build_index (GtkCssSelectorTree *tree)
+{
+  GtkCssSelectorTreeIndex *index = gtk_css_selector_tree_get_index (tree);
+  const GtkCssSelectorTree *iter;
+
+  index->names = g_hash_table_new (NULL, NULL);
+  index->classes = g_hash_table_new (NULL, NULL);
+  index->ids = g_hash_table_new (NULL, NULL);
+  index->others = g_ptr_array_new ();
+
+  /* Every top level tree checks a different selector, so there
+   * is at most one tree per bucket.
+   */
+  for (iter = tree; iter != NULL; iter = gtk_css_selector_tree_get_sibling (iter))
+    {
+      if (iter->selector.class == &GTK_CSS_SELECTOR_NAME)
+        g_hash_table_insert (index->names, GUINT_TO_POINTER (iter->selector.name.name), (gpointer) iter);
+      else if (iter->selector.class == &GTK_CSS_SELECTOR_CLASS)
+        g_hash_table_insert (index->classes, GUINT_TO_POINTER (iter->selector.style_class.style_class), (gpointer) iter);
+      else if (iter->selector.class == &GTK_CSS_SELECTOR_ID)
+        g_hash_table_insert (index->ids, GUINT_TO_POINTER (iter->selector.id.name), (gpointer) iter);
+      else
+        g_ptr_array_add (index->others, (gpointer) iter);
+    }
+}
+
 GtkCssSelectorTree *
 _gtk_css_selector_tree_builder_build (GtkCssSelectorTreeBuilder *builder)
 {
@@ -2281,6 +2453,9 @@ _gtk_css_selector_tree_builder_build (GtkCssSelectorTreeBuilder *builder)
 
   array = g_byte_array_new ();
 
+  /* Reserve space for the index in front of the tree */
+  g_byte_array_set_size (array, GTK_CSS_SELECTOR_TREE_INDEX_SIZE);
+
   infos_array = g_alloca (sizeof (GtkCssSelectorRuleSetInfo *) * builder->infos->len);
   for (i = 0; i < builder->infos->len; i++)
     infos_array[i] = &g_array_index (builder->infos, GtkCssSelectorRuleSetInfo, i);
@@ -2290,10 +2465,16 @@ _gtk_css_selector_tree_builder_build (GtkCssSelectorTreeBuilder *builder)
   len = array->len;
   data = g_byte_array_free (array, FALSE);
 
+  if (len == GTK_CSS_SELECTOR_TREE_INDEX_SIZE)
+    {
+      g_free (data);
+      return NULL;
+    }
+
   /* shrink to final size */
   data = g_realloc (data, len);
 
-  tree = (GtkCssSelectorTree *)data;
+  tree = (GtkCssSelectorTree *)(data + GTK_CSS_SELECTOR_TREE_INDEX_SIZE);
 
   fixup_offsets (tree, data);
 
@@ -2307,6 +2488,8 @@ _gtk_css_selector_tree_builder_build (GtkCssSelectorTreeBuilder *builder)
     }
 
 
+  gtk_css_selector_tree_build_index (tree);
+
 #ifdef PRINT_TREE
   {
     GString *s = g_string_new ("");
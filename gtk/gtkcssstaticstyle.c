@@ -38,6 +38,7 @@
 #include "gtkstylepropertyprivate.h"
 #include "gtkstyleproviderprivate.h"
 #include "gtkcssdimensionvalueprivate.h"
+#include "gdk/gdkprofilerprivate.h"
 
 static void gtk_css_static_style_compute_value (GtkCssStaticStyle *style,
                                                 GtkStyleProvider  *provider,
@@ -46,6 +47,12 @@ static void gtk_css_static_style_compute_value (GtkCssStaticStyle *style,
                                                 GtkCssValue       *specified,
                                                 GtkCssSection     *section);
 
+/* Time spent in selector matching and in value computation,
+ * accumulated while the profiler is running.
+ */
+static gint64 match_time;
+static gint64 compute_time;
+
 static const int core_props[] = {
   GTK_CSS_PROPERTY_COLOR,
   GTK_CSS_PROPERTY_DPI,
@@ -214,6 +221,30 @@ gtk_css_ ## NAME ## _values_new_compute (GtkCssStaticStyle *sstyle, \
                                           lookup->values[id].section); \
     } \
 } \
+/* Replaces the freshly computed values with @other if they are \
+ * all the same, so styles that end up with their parent's or the \
+ * initial values don't keep a copy of their own. \
+ */ \
+static inline void \
+gtk_css_ ## NAME ## _values_share (GtkCssStaticStyle *sstyle, \
+                                   GtkCssValues      *other) \
+{ \
+  GtkCssStyle *style = (GtkCssStyle *)sstyle; \
+  GtkCssValue **g1 = GET_VALUES (style->NAME); \
+  GtkCssValue **g2 = GET_VALUES (other); \
+  int i; \
+\
+  for (i = 0; i < G_N_ELEMENTS (NAME ## _props); i++) \
+    { \
+      if (g1[i] == g2[i]) \
+        continue; \
+      if (g1[i] == NULL || g2[i] == NULL || !_gtk_css_value_equal (g1[i], g2[i])) \
+        return; \
+    } \
+\
+  gtk_css_values_unref ((GtkCssValues *)style->NAME); \
+  style->NAME = (GtkCss ## TYPE ## Values *)gtk_css_values_ref (other); \
+} \
 static GtkBitmask * gtk_css_ ## NAME ## _values_mask; \
 static GtkCssValues * gtk_css_ ## NAME ## _initial_values; \
 \
@@ -929,57 +960,93 @@ gtk_css_lookup_resolve (GtkCssLookup      *lookup,
   if (parent_style && gtk_css_core_values_unset (lookup))
     style->core = (GtkCssCoreValues *)gtk_css_values_ref ((GtkCssValues *)parent_style->core);
   else
-    gtk_css_core_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_core_values_new_compute (sstyle, provider, parent_style, lookup);
+      if (parent_style)
+        gtk_css_core_values_share (sstyle, (GtkCssValues *)parent_style->core);
+    }
 
   if (gtk_css_background_values_unset (lookup))
     style->background = (GtkCssBackgroundValues *)gtk_css_values_ref (gtk_css_background_initial_values);
   else
-    gtk_css_background_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_background_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_background_values_share (sstyle, gtk_css_background_initial_values);
+    }
 
   if (gtk_css_border_values_unset (lookup))
     style->border = (GtkCssBorderValues *)gtk_css_values_ref (gtk_css_border_initial_values);
   else
-    gtk_css_border_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_border_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_border_values_share (sstyle, gtk_css_border_initial_values);
+    }
 
   if (parent_style && gtk_css_icon_values_unset (lookup))
     style->icon = (GtkCssIconValues *)gtk_css_values_ref ((GtkCssValues *)parent_style->icon);
   else
-    gtk_css_icon_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_icon_values_new_compute (sstyle, provider, parent_style, lookup);
+      if (parent_style)
+        gtk_css_icon_values_share (sstyle, (GtkCssValues *)parent_style->icon);
+    }
 
   if (gtk_css_outline_values_unset (lookup))
     style->outline = (GtkCssOutlineValues *)gtk_css_values_ref (gtk_css_outline_initial_values);
   else
-    gtk_css_outline_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_outline_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_outline_values_share (sstyle, gtk_css_outline_initial_values);
+    }
 
   if (parent_style && gtk_css_font_values_unset (lookup))
     style->font = (GtkCssFontValues *)gtk_css_values_ref ((GtkCssValues *)parent_style->font);
   else
-    gtk_css_font_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_font_values_new_compute (sstyle, provider, parent_style, lookup);
+      if (parent_style)
+        gtk_css_font_values_share (sstyle, (GtkCssValues *)parent_style->font);
+    }
 
   if (gtk_css_font_variant_values_unset (lookup))
     style->font_variant = (GtkCssFontVariantValues *)gtk_css_values_ref (gtk_css_font_variant_initial_values);
   else
-    gtk_css_font_variant_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_font_variant_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_font_variant_values_share (sstyle, gtk_css_font_variant_initial_values);
+    }
 
   if (gtk_css_animation_values_unset (lookup))
     style->animation = (GtkCssAnimationValues *)gtk_css_values_ref (gtk_css_animation_initial_values);
   else
-    gtk_css_animation_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_animation_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_animation_values_share (sstyle, gtk_css_animation_initial_values);
+    }
 
   if (gtk_css_transition_values_unset (lookup))
     style->transition = (GtkCssTransitionValues *)gtk_css_values_ref (gtk_css_transition_initial_values);
   else
-    gtk_css_transition_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_transition_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_transition_values_share (sstyle, gtk_css_transition_initial_values);
+    }
 
   if (gtk_css_size_values_unset (lookup))
     style->size = (GtkCssSizeValues *)gtk_css_values_ref (gtk_css_size_initial_values);
   else
-    gtk_css_size_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_size_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_size_values_share (sstyle, gtk_css_size_initial_values);
+    }
 
   if (gtk_css_other_values_unset (lookup))
     style->other = (GtkCssOtherValues *)gtk_css_values_ref (gtk_css_other_initial_values);
   else
-    gtk_css_other_values_new_compute (sstyle, provider, parent_style, lookup);
+    {
+      gtk_css_other_values_new_compute (sstyle, provider, parent_style, lookup);
+      gtk_css_other_values_share (sstyle, gtk_css_other_initial_values);
+    }
 }
 
 GtkCssStyle *
@@ -991,9 +1058,15 @@ gtk_css_static_style_new_compute (GtkStyleProvider             *provider,
   GtkCssStaticStyle *result;
   GtkCssLookup lookup;
   GtkCssNode *parent;
+  gboolean profiling = GDK_PROFILER_IS_RUNNING;
+  gint64 before G_GNUC_UNUSED = 0;
+  gint64 after G_GNUC_UNUSED;
 
   _gtk_css_lookup_init (&lookup);
 
+  if (profiling)
+    before = GDK_PROFILER_CURRENT_TIME;
+
   if (node)
     gtk_style_provider_lookup (provider,
                                filter,
@@ -1001,6 +1074,13 @@ gtk_css_static_style_new_compute (GtkStyleProvider             *provider,
                                &lookup,
                                change == 0 ? &change : NULL);
 
+  if (profiling)
+    {
+      after = GDK_PROFILER_CURRENT_TIME;
+      match_time += after - before;
+      before = after;
+    }
+
   result = g_object_new (GTK_TYPE_CSS_STATIC_STYLE, NULL);
 
   result->change = change;
@@ -1015,11 +1095,29 @@ gtk_css_static_style_new_compute (GtkStyleProvider             *provider,
                           result,
                           parent ? gtk_css_node_get_style (parent) : NULL);
 
+  if (profiling)
+    compute_time += GDK_PROFILER_CURRENT_TIME - before;
+
   _gtk_css_lookup_destroy (&lookup);
 
   return GTK_CSS_STYLE (result);
 }
 
+/* Returns the time spent in selector matching and value computation
+ * since the last call, in nanoseconds. This is only tracked while
+ * the profiler is running.
+ */
+void
+gtk_css_static_style_steal_timings (gint64 *match,
+                                    gint64 *compute)
+{
+  *match = match_time;
+  *compute = compute_time;
+
+  match_time = 0;
+  compute_time = 0;
+}
+
 G_STATIC_ASSERT (GTK_CSS_PROPERTY_BORDER_TOP_STYLE == GTK_CSS_PROPERTY_BORDER_TOP_WIDTH - 1);
 G_STATIC_ASSERT (GTK_CSS_PROPERTY_BORDER_RIGHT_STYLE == GTK_CSS_PROPERTY_BORDER_RIGHT_WIDTH - 1);
 G_STATIC_ASSERT (GTK_CSS_PROPERTY_BORDER_BOTTOM_STYLE == GTK_CSS_PROPERTY_BORDER_BOTTOM_WIDTH - 1);
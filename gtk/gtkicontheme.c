@@ -414,14 +414,23 @@ typedef struct
 
   GArray *dir_sizes;     /* IconThemeDirSize */
   GArray *dirs;          /* IconThemeDir */
+  GArray *icon_files;    /* IconThemeFile */
+  GHashTable *icon_index; /* name (interned) -> index of first file */
   GtkStringSet icons;
 } IconTheme;
 
+#define ICON_THEME_NO_FILE G_MAXUINT32
+
+/* All the files for an icon name form a list, sorted by dir size,
+ * so that lookups only look at the dir sizes containing the icon.
+ */
 typedef struct
 {
-  guint16 dir_index;    /* index in dirs */
+  guint16 dir_index;      /* index in dirs */
+  guint16 dir_size_index; /* index in dir_sizes */
   guint8 best_suffix;
   guint8 best_suffix_no_svg;
+  guint32 next;           /* index of next file with the same name */
 } IconThemeFile;
 
 typedef struct
@@ -432,9 +441,6 @@ typedef struct
   int max_size;
   int threshold;
   int scale;
-
-  GArray *icon_files;
-  GHashTable *icon_hash; /* name (interned) -> file index */
 } IconThemeDirSize;
 
 typedef struct
@@ -462,7 +468,6 @@ static void              gtk_icon_theme_finalize          (GObject          *obj
 static void              gtk_icon_theme_dispose           (GObject          *object);
 static IconTheme *       theme_new                        (const char       *theme_name,
                                                            GKeyFile         *theme_file);
-static void              theme_dir_size_destroy           (IconThemeDirSize *dir_size);
 static void              theme_dir_destroy                (IconThemeDir     *dir);
 static void              theme_destroy                    (IconTheme        *theme);
 static GtkIconPaintable *theme_lookup_icon                (IconTheme        *theme,
@@ -2636,7 +2641,7 @@ gtk_icon_theme_get_icon_sizes (GtkIconTheme *self,
                                const char   *icon_name)
 {
   GList *l;
-  int i;
+  guint i;
   GHashTable *sizes;
   int *result, *r;
 
@@ -2652,15 +2657,19 @@ gtk_icon_theme_get_icon_sizes (GtkIconTheme *self,
     {
       IconTheme *theme = l->data;
       const char *interned_icon_name = gtk_string_set_lookup (&theme->icons, icon_name);
+      gpointer first;
 
-      for (i = 0; i < theme->dir_sizes->len; i++)
+      if (!g_hash_table_lookup_extended (theme->icon_index, interned_icon_name, NULL, &first))
+        continue;
+
+      for (i = GPOINTER_TO_UINT (first); i != ICON_THEME_NO_FILE; )
         {
-          IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, i);
+          IconThemeFile *file = &g_array_index (theme->icon_files, IconThemeFile, i);
+          IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, file->dir_size_index);
 
-          if (dir_size->type != ICON_THEME_DIR_SCALABLE && g_hash_table_lookup_extended (sizes, GINT_TO_POINTER (dir_size->size), NULL, NULL))
-            continue;
+          i = file->next;
 
-          if (!g_hash_table_contains (dir_size->icon_hash, interned_icon_name))
+          if (dir_size->type != ICON_THEME_DIR_SCALABLE && g_hash_table_lookup_extended (sizes, GINT_TO_POINTER (dir_size->size), NULL, NULL))
             continue;
 
           if (dir_size->type == ICON_THEME_DIR_SCALABLE)
@@ -2785,6 +2794,9 @@ theme_new (const char *theme_name,
   theme->name = g_strdup (theme_name);
   theme->dir_sizes = g_array_new (FALSE, FALSE, sizeof (IconThemeDirSize));
   theme->dirs = g_array_new (FALSE, FALSE, sizeof (IconThemeDir));
+  theme->icon_files = g_array_new (FALSE, FALSE, sizeof (IconThemeFile));
+  /* The keys are interned strings, so use direct hash/equal */
+  theme->icon_index = g_hash_table_new (g_direct_hash, g_direct_equal);
   gtk_string_set_init (&theme->icons);
 
   theme->display_name =
@@ -2808,28 +2820,20 @@ theme_destroy (IconTheme *theme)
   g_free (theme->display_name);
   g_free (theme->comment);
 
-  for (i = 0; i < theme->dir_sizes->len; i++)
-    theme_dir_size_destroy (&g_array_index (theme->dir_sizes, IconThemeDirSize, i));
   g_array_free (theme->dir_sizes, TRUE);
 
   for (i = 0; i < theme->dirs->len; i++)
     theme_dir_destroy (&g_array_index (theme->dirs, IconThemeDir, i));
   g_array_free (theme->dirs, TRUE);
 
+  g_array_free (theme->icon_files, TRUE);
+  g_hash_table_destroy (theme->icon_index);
+
   gtk_string_set_destroy (&theme->icons);
 
   g_free (theme);
 }
 
-static void
-theme_dir_size_destroy (IconThemeDirSize *dir)
-{
-  if (dir->icon_hash)
-    g_hash_table_destroy (dir->icon_hash);
-  if (dir->icon_files)
-    g_array_free (dir->icon_files, TRUE);
-}
-
 static void
 theme_dir_destroy (IconThemeDir *dir)
 {
@@ -3014,7 +3018,8 @@ theme_lookup_icon (IconTheme   *theme,
   IconThemeFile *min_file;
   int min_difference;
   IconCacheFlag min_suffix;
-  int i;
+  gpointer first;
+  guint i;
 
   /* Its not uncommon with misses, so we do an early check which allows us do
    * do a lot less work.
@@ -3023,22 +3028,20 @@ theme_lookup_icon (IconTheme   *theme,
   if (icon_name == NULL)
     return FALSE;
 
+  if (!g_hash_table_lookup_extended (theme->icon_index, icon_name, NULL, &first))
+    return NULL;
+
   min_difference = G_MAXINT;
   min_dir_size = NULL;
 
-  for (i = 0; i < theme->dir_sizes->len; i++)
+  for (i = GPOINTER_TO_UINT (first); i != ICON_THEME_NO_FILE; )
     {
-      IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, i);
-      IconThemeFile *file;
+      IconThemeFile *file = &g_array_index (theme->icon_files, IconThemeFile, i);
+      IconThemeDirSize *dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, file->dir_size_index);
       guint best_suffix;
       int difference;
-      gpointer file_index;
-
-      if (!g_hash_table_lookup_extended (dir_size->icon_hash, icon_name, NULL, &file_index))
-        continue;
-
-      file = &g_array_index (dir_size->icon_files, IconThemeFile, GPOINTER_TO_INT(file_index));
 
+      i = file->next;
 
       if (allow_svg)
         best_suffix = file->best_suffix;
@@ -3214,10 +3217,6 @@ theme_ensure_dir_size (IconTheme *theme,
         return index;
     }
 
-  new.icon_files = g_array_new (FALSE, FALSE, sizeof (IconThemeFile));
-  /* The keys are interned strings, so use direct hash/equal */
-  new.icon_hash = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, NULL);
-
   index = theme->dir_sizes->len;
   g_array_append_val (theme->dir_sizes, new);
 
@@ -3244,30 +3243,54 @@ static void
 theme_add_icon_file (IconTheme *theme,
                      const char *icon_name, /* interned */
                      guint suffixes,
-                     IconThemeDirSize *dir_size,
+                     guint dir_size_index,
                      guint dir_index)
 {
   IconThemeFile new_file = { 0 };
-  guint index;
+  gpointer first;
+  guint32 index, prev, next;
 
-  if (g_hash_table_contains (dir_size->icon_hash, icon_name))
-    return;
+  if (g_hash_table_lookup_extended (theme->icon_index, icon_name, NULL, &first))
+    next = GPOINTER_TO_UINT (first);
+  else
+    next = ICON_THEME_NO_FILE;
+
+  /* Keep the list sorted by dir size, lookups depend on the order
+   * when breaking ties. The first dir for a dir size wins. */
+  prev = ICON_THEME_NO_FILE;
+  while (next != ICON_THEME_NO_FILE)
+    {
+      IconThemeFile *file = &g_array_index (theme->icon_files, IconThemeFile, next);
+
+      if (file->dir_size_index == dir_size_index)
+        return;
+
+      if (file->dir_size_index > dir_size_index)
+        break;
+
+      prev = next;
+      next = file->next;
+    }
 
   new_file.dir_index = dir_index;
+  new_file.dir_size_index = dir_size_index;
   new_file.best_suffix = best_suffix (suffixes, TRUE);
   new_file.best_suffix_no_svg = best_suffix (suffixes, FALSE);
+  new_file.next = next;
 
-  index = dir_size->icon_files->len;
-  g_array_append_val (dir_size->icon_files, new_file);
-
-  g_hash_table_insert (dir_size->icon_hash, (char *)icon_name, GINT_TO_POINTER(index));
+  index = theme->icon_files->len;
+  g_array_append_val (theme->icon_files, new_file);
 
+  if (prev == ICON_THEME_NO_FILE)
+    g_hash_table_insert (theme->icon_index, (char *)icon_name, GUINT_TO_POINTER (index));
+  else
+    g_array_index (theme->icon_files, IconThemeFile, prev).next = index;
 }
 
 /* Icon names are are already interned */
 static void
 theme_add_dir_with_icons (IconTheme *theme,
-                          IconThemeDirSize *dir_size,
+                          guint dir_size_index,
                           gboolean is_resource,
                           char *path /* takes ownership */,
                           GHashTable *icons)
@@ -3283,7 +3306,7 @@ theme_add_dir_with_icons (IconTheme *theme,
     {
       const char *icon_name = key; /* interned */
       guint suffixes = GPOINTER_TO_INT(value);
-      theme_add_icon_file (theme, icon_name, suffixes, dir_size, dir_index);
+      theme_add_icon_file (theme, icon_name, suffixes, dir_size_index, dir_index);
     }
 }
 
@@ -3301,7 +3324,6 @@ theme_subdir_load (GtkIconTheme *self,
   int threshold;
   GError *error = NULL;
   guint32 dir_size_index;
-  IconThemeDirSize *dir_size;
   int scale;
   guint i;
 
@@ -3349,7 +3371,6 @@ theme_subdir_load (GtkIconTheme *self,
     scale = 1;
 
   dir_size_index = theme_ensure_dir_size (theme, type, size, min_size, max_size, threshold, scale);
-  dir_size = &g_array_index (theme->dir_sizes, IconThemeDirSize, dir_size_index);
 
   for (i = 0; i < self->dir_mtimes->len; i++)
     {
@@ -3380,7 +3401,7 @@ theme_subdir_load (GtkIconTheme *self,
           if (icons)
             {
               theme_add_dir_with_icons (theme,
-                                        dir_size,
+                                        dir_size_index,
                                         FALSE,
                                         g_steal_pointer (&full_dir),
                                         icons);
@@ -3407,7 +3428,7 @@ theme_subdir_load (GtkIconTheme *self,
           if (icons)
             {
               theme_add_dir_with_icons (theme,
-                                        dir_size,
+                                        dir_size_index,
                                         TRUE,
                                         g_steal_pointer (&full_dir),
                                         icons);
@@ -283,12 +283,23 @@ struct _GtkLabel
   guint    single_line_mode   : 1;
   guint    in_click           : 1;
   guint    track_links        : 1;
+  guint    size_valid         : 1;
 
   guint    mnemonic_keyval;
 
   int      width_chars;
   int      max_width_chars;
   int      lines;
+
+  /* The result of gtk_label_get_preferred_layout_size(), which is
+   * needed for both orientations, and would otherwise lay out and
+   * shape the text again for each of them.
+   */
+  PangoRectangle smallest_rect;
+  PangoRectangle widest_rect;
+  int            smallest_baseline;
+  int            widest_baseline;
+  guint          size_context_serial;
 };
 
 struct _GtkLabelClass
@@ -426,6 +437,8 @@ static void gtk_label_state_flags_changed   (GtkWidget        *widget,
                                              GtkStateFlags     prev_state);
 static void gtk_label_css_changed       (GtkWidget         *widget,
                                          GtkCssStyleChange *change);
+static void gtk_label_direction_changed (GtkWidget         *widget,
+                                         GtkTextDirection   previous_dir);
 static void gtk_label_snapshot          (GtkWidget         *widget,
                                          GtkSnapshot       *snapshot);
 static gboolean gtk_label_focus         (GtkWidget         *widget,
@@ -612,6 +625,7 @@ gtk_label_class_init (GtkLabelClass *class)
   widget_class->size_allocate = gtk_label_size_allocate;
   widget_class->state_flags_changed = gtk_label_state_flags_changed;
   widget_class->css_changed = gtk_label_css_changed;
+  widget_class->direction_changed = gtk_label_direction_changed;
   widget_class->query_tooltip = gtk_label_query_tooltip;
   widget_class->snapshot = gtk_label_snapshot;
   widget_class->unrealize = gtk_label_unrealize;
@@ -2573,6 +2587,7 @@ gtk_label_set_width_chars (GtkLabel *self,
   if (self->width_chars != n_chars)
     {
       self->width_chars = n_chars;
+      self->size_valid = FALSE;
       g_object_notify_by_pspec (G_OBJECT (self), label_props[PROP_WIDTH_CHARS]);
       gtk_widget_queue_resize (GTK_WIDGET (self));
     }
@@ -2611,6 +2626,7 @@ gtk_label_set_max_width_chars (GtkLabel *self,
   if (self->max_width_chars != n_chars)
     {
       self->max_width_chars = n_chars;
+      self->size_valid = FALSE;
 
       g_object_notify_by_pspec (G_OBJECT (self), label_props[PROP_MAX_WIDTH_CHARS]);
       gtk_widget_queue_resize (GTK_WIDGET (self));
@@ -2702,6 +2718,7 @@ gtk_label_set_wrap_mode (GtkLabel *self,
   if (self->wrap_mode != wrap_mode)
     {
       self->wrap_mode = wrap_mode;
+      gtk_label_clear_layout (self);
       g_object_notify_by_pspec (G_OBJECT (self), label_props[PROP_WRAP_MODE]);
 
       gtk_widget_queue_resize (GTK_WIDGET (self));
@@ -2762,6 +2779,7 @@ static void
 gtk_label_clear_layout (GtkLabel *self)
 {
   g_clear_object (&self->layout);
+  self->size_valid = FALSE;
 }
 
 /**
@@ -2909,6 +2927,7 @@ gtk_label_update_layout_attributes (GtkLabel      *self,
   attrs = _gtk_pango_attr_list_merge (attrs, self->attrs);
 
   pango_layout_set_attributes (self->layout, attrs);
+  self->size_valid = FALSE;
 
   pango_attr_list_unref (attrs);
 }
@@ -3107,10 +3126,24 @@ gtk_label_get_preferred_size (GtkWidget      *widget,
   PangoRectangle smallest_rect;
   int smallest_baseline;
   int widest_baseline;
+  guint serial;
 
-  gtk_label_get_preferred_layout_size (self,
-                                       &smallest_rect, &widest_rect,
-                                       &smallest_baseline, &widest_baseline);
+  /* Font changes don't clear the layout, so check the context too */
+  serial = pango_context_get_serial (gtk_widget_get_pango_context (widget));
+
+  if (!self->size_valid || self->size_context_serial != serial)
+    {
+      gtk_label_get_preferred_layout_size (self,
+                                           &self->smallest_rect, &self->widest_rect,
+                                           &self->smallest_baseline, &self->widest_baseline);
+      self->size_context_serial = serial;
+      self->size_valid = TRUE;
+    }
+
+  smallest_rect = self->smallest_rect;
+  widest_rect = self->widest_rect;
+  smallest_baseline = self->smallest_baseline;
+  widest_baseline = self->widest_baseline;
 
   widest_rect.width  = PANGO_PIXELS_CEIL (widest_rect.width);
   widest_rect.height = PANGO_PIXELS_CEIL (widest_rect.height);
@@ -3164,12 +3197,13 @@ gtk_label_measure (GtkWidget      *widget,
 {
   GtkLabel *self = GTK_LABEL (widget);
 
+  /* Don't throw away the layout here. gtk_label_get_measuring_layout()
+   * hands out a copy for widths other than the allocated one, so the
+   * label's own layout and its line breaks stay valid for measuring
+   * at the allocated width and for drawing.
+   */
   if (orientation == GTK_ORIENTATION_VERTICAL && for_size != -1 && self->wrap)
-    {
-      gtk_label_clear_layout (self);
-
-      get_height_for_width (self, for_size, minimum, natural, minimum_baseline, natural_baseline);
-    }
+    get_height_for_width (self, for_size, minimum, natural, minimum_baseline, natural_baseline);
   else
     gtk_label_get_preferred_size (widget, orientation, minimum, natural, minimum_baseline, natural_baseline);
 }
@@ -3329,6 +3363,18 @@ gtk_label_state_flags_changed (GtkWidget     *widget,
     GTK_WIDGET_CLASS (gtk_label_parent_class)->state_flags_changed (widget, prev_state);
 }
 
+static void
+gtk_label_direction_changed (GtkWidget        *widget,
+                             GtkTextDirection  previous_dir)
+{
+  GtkLabel *self = GTK_LABEL (widget);
+
+  /* The alignment of the layout depends on the direction */
+  gtk_label_clear_layout (self);
+
+  GTK_WIDGET_CLASS (gtk_label_parent_class)->direction_changed (widget, previous_dir);
+}
+
 static void 
 gtk_label_css_changed (GtkWidget         *widget,
                        GtkCssStyleChange *change)
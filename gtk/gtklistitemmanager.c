@@ -21,10 +21,14 @@
 
 #include "gtklistitemmanagerprivate.h"
 
+#include "gtkcssnodeprivate.h"
 #include "gtklistitemwidgetprivate.h"
 #include "gtkwidgetprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 #define GTK_LIST_VIEW_MAX_LIST_ITEMS 200
+#define GTK_LIST_VIEW_MAX_RECYCLED_ITEMS 50
 
 struct _GtkListItemManager
 {
@@ -38,6 +42,16 @@ struct _GtkListItemManager
 
   GtkRbTree *items;
   GSList *trackers;
+
+  /* released widgets that are still set up, but not bound to an item */
+  GQueue recycled;
+
+  /* items-changed emissions that didn't touch any widgets are only
+   * applied to the tree right away, the widgets are updated once per
+   * frame from a tick callback */
+  guint flush_changes_id;
+  guint pending_update_start;
+  guint n_coalesced_changes;
 };
 
 struct _GtkListItemManagerClass
@@ -71,8 +85,19 @@ static void             gtk_list_item_manager_move_list_item    (GtkListItemMana
 static void             gtk_list_item_manager_release_list_item (GtkListItemManager     *self,
                                                                  GHashTable             *change,
                                                                  GtkWidget              *widget);
+static void             gtk_list_item_manager_recycle_list_item (GtkListItemManager     *self,
+                                                                 GtkWidget              *item);
+static void             gtk_list_item_manager_recycle_change    (GtkListItemManager     *self,
+                                                                 GHashTable             *change);
+static void             gtk_list_item_manager_flush_changes     (GtkListItemManager     *self);
 G_DEFINE_TYPE (GtkListItemManager, gtk_list_item_manager, G_TYPE_OBJECT)
 
+static guint coalesced_changes_counter;
+static guint created_list_items_counter;
+static guint recycled_list_items_counter;
+static gint64 created_list_items;
+static gint64 recycled_list_items;
+
 void
 gtk_list_item_manager_augment_node (GtkRbTree *tree,
                                     gpointer   node_augment,
@@ -569,6 +594,146 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
     gtk_list_item_manager_release_list_item (self, NULL, widget);
 }
 
+/* Grab the missing widgets of trackers.
+ * For items that had been removed and a new position was set, grab
+ * their item now that we ensured it exists.
+ */
+static void
+gtk_list_item_manager_ensure_tracker_widgets (GtkListItemManager *self)
+{
+  GSList *l;
+
+  for (l = self->trackers; l; l = l->next)
+    {
+      GtkListItemTracker *tracker = l->data;
+      GtkListItemManagerItem *item;
+
+      if (tracker->widget != NULL || 
+          tracker->position == GTK_INVALID_LIST_POSITION)
+        continue;
+
+      item = gtk_list_item_manager_get_nth (self, tracker->position, NULL);
+      g_assert (item != NULL);
+      g_assert (item->widget);
+      tracker->widget = GTK_LIST_ITEM_WIDGET (item->widget);
+    }
+}
+
+static gboolean
+gtk_list_item_manager_flush_changes_cb (GtkWidget     *widget,
+                                        GdkFrameClock *frame_clock,
+                                        gpointer       data)
+{
+  GtkListItemManager *self = data;
+
+  gtk_list_item_manager_flush_changes (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Forgets about deferred changes, the caller must update the widgets
+ * itself. */
+static void
+gtk_list_item_manager_cancel_changes (GtkListItemManager *self)
+{
+  if (self->flush_changes_id == 0)
+    return;
+
+  gtk_widget_remove_tick_callback (self->widget, self->flush_changes_id);
+  self->flush_changes_id = 0;
+  self->pending_update_start = G_MAXUINT;
+
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_set_int_counter (coalesced_changes_counter, self->n_coalesced_changes);
+  self->n_coalesced_changes = 0;
+}
+
+/*
+ * gtk_list_item_manager_flush_changes:
+ * @self: a #GtkListItemManager
+ *
+ * Updates the widgets for all changes that were deferred by
+ * gtk_list_item_manager_model_items_changed_cb().
+ *
+ * This must be called before anything that relies on the widgets
+ * matching the tree.
+ **/
+static void
+gtk_list_item_manager_flush_changes (GtkListItemManager *self)
+{
+  guint update_start;
+
+  if (self->flush_changes_id == 0)
+    return;
+
+  update_start = self->pending_update_start;
+  gtk_list_item_manager_cancel_changes (self);
+
+  gtk_list_item_manager_ensure_items (self, NULL, update_start);
+  gtk_list_item_manager_ensure_tracker_widgets (self);
+}
+
+/* We can only defer updating the widgets if no widget is affected
+ * by the change. That is only the case for changes after the last
+ * widget and tracker, as widgets and trackers after the change would
+ * need their positions updated right away.
+ */
+static gboolean
+gtk_list_item_manager_can_defer_change (GtkListItemManager *self,
+                                        guint               position)
+{
+  GtkListItemManagerItem *item;
+  GSList *l;
+
+  if (!gtk_widget_get_mapped (self->widget))
+    return FALSE;
+
+  /* An empty list needs its trackers set up */
+  if (gtk_rb_tree_get_root (self->items) == NULL)
+    return FALSE;
+
+  for (l = self->trackers; l; l = l->next)
+    {
+      GtkListItemTracker *tracker = l->data;
+
+      if (tracker->position != GTK_INVALID_LIST_POSITION &&
+          tracker->position >= position)
+        return FALSE;
+    }
+
+  for (item = gtk_list_item_manager_get_nth (self, position, NULL);
+       item != NULL;
+       item = gtk_rb_tree_node_get_next (item))
+    {
+      if (item->widget)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+gtk_list_item_manager_defer_change (GtkListItemManager *self,
+                                    guint               position,
+                                    guint               removed,
+                                    guint               added)
+{
+  gtk_list_item_manager_remove_items (self, NULL, position, removed);
+  gtk_list_item_manager_add_items (self, position, added);
+
+  self->pending_update_start = MIN (self->pending_update_start, position);
+
+  if (self->flush_changes_id == 0)
+    self->flush_changes_id = gtk_widget_add_tick_callback (self->widget,
+                                                           gtk_list_item_manager_flush_changes_cb,
+                                                           self,
+                                                           NULL);
+  else
+    self->n_coalesced_changes++;
+
+  gtk_widget_queue_resize (self->widget);
+}
+
 static void
 gtk_list_item_manager_model_items_changed_cb (GListModel         *model,
                                               guint               position,
@@ -578,7 +743,18 @@ gtk_list_item_manager_model_items_changed_cb (GListModel         *model,
 {
   GHashTable *change;
   GSList *l;
-  guint n_items;
+  guint n_items, update_start;
+
+  if (gtk_list_item_manager_can_defer_change (self, position))
+    {
+      gtk_list_item_manager_defer_change (self, position, removed, added);
+      return;
+    }
+
+  /* The tree already contains all deferred changes, so we can pick
+   * them up with the widget updates below. */
+  update_start = MIN (position + added, self->pending_update_start);
+  gtk_list_item_manager_cancel_changes (self);
 
   n_items = g_list_model_get_n_items (G_LIST_MODEL (self->model));
   change = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify )gtk_widget_unparent);
@@ -677,7 +853,8 @@ gtk_list_item_manager_model_items_changed_cb (GListModel         *model,
         }
       else if (tracker->position >= position)
         {
-          if (g_hash_table_lookup (change, gtk_list_item_widget_get_item (tracker->widget)))
+          if (tracker->widget == NULL ||
+              g_hash_table_lookup (change, gtk_list_item_widget_get_item (tracker->widget)))
             {
               /* The item is gone. Guess a good new position */
               tracker->position = position + (tracker->position - position) * added / removed;
@@ -704,27 +881,11 @@ gtk_list_item_manager_model_items_changed_cb (GListModel         *model,
         }
     }
 
-  gtk_list_item_manager_ensure_items (self, change, position + added);
+  gtk_list_item_manager_ensure_items (self, change, update_start);
 
-  /* final loop through the trackers: Grab the missing widgets.
-   * For items that had been removed and a new position was set, grab
-   * their item now that we ensured it exists.
-   */
-  for (l = self->trackers; l; l = l->next)
-    {
-      GtkListItemTracker *tracker = l->data;
-      GtkListItemManagerItem *item;
-
-      if (tracker->widget != NULL || 
-          tracker->position == GTK_INVALID_LIST_POSITION)
-        continue;
-
-      item = gtk_list_item_manager_get_nth (self, tracker->position, NULL);
-      g_assert (item != NULL);
-      g_assert (item->widget);
-      tracker->widget = GTK_LIST_ITEM_WIDGET (item->widget);
-    }
+  gtk_list_item_manager_ensure_tracker_widgets (self);
 
+  gtk_list_item_manager_recycle_change (self, change);
   g_hash_table_unref (change);
 
   gtk_widget_queue_resize (self->widget);
@@ -769,6 +930,7 @@ gtk_list_item_manager_clear_model (GtkListItemManager *self)
   if (self->model == NULL)
     return;
 
+  gtk_list_item_manager_cancel_changes (self);
   gtk_list_item_manager_remove_items (self, NULL, 0, g_list_model_get_n_items (G_LIST_MODEL (self->model)));
   for (l = self->trackers; l; l = l->next)
     {
@@ -784,12 +946,22 @@ gtk_list_item_manager_clear_model (GtkListItemManager *self)
   g_clear_object (&self->model);
 }
 
+static void
+gtk_list_item_manager_clear_recycled (GtkListItemManager *self)
+{
+  GtkWidget *widget;
+
+  while ((widget = g_queue_pop_head (&self->recycled)))
+    gtk_widget_unparent (widget);
+}
+
 static void
 gtk_list_item_manager_dispose (GObject *object)
 {
   GtkListItemManager *self = GTK_LIST_ITEM_MANAGER (object);
 
   gtk_list_item_manager_clear_model (self);
+  gtk_list_item_manager_clear_recycled (self);
 
   g_clear_object (&self->factory);
 
@@ -804,11 +976,19 @@ gtk_list_item_manager_class_init (GtkListItemManagerClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->dispose = gtk_list_item_manager_dispose;
+
+  if (coalesced_changes_counter == 0)
+    {
+      coalesced_changes_counter = gdk_profiler_define_int_counter ("coalesced-list-changes", "Coalesced list model changes");
+      created_list_items_counter = gdk_profiler_define_int_counter ("created-list-items", "List item setups");
+      recycled_list_items_counter = gdk_profiler_define_int_counter ("recycled-list-items", "Recycled list items");
+    }
 }
 
 static void
 gtk_list_item_manager_init (GtkListItemManager *self)
 {
+  self->pending_update_start = G_MAXUINT;
 }
 
 void
@@ -824,8 +1004,12 @@ gtk_list_item_manager_set_factory (GtkListItemManager *self,
   if (self->factory == factory)
     return;
 
+  gtk_list_item_manager_flush_changes (self);
+
   n_items = self->model ? g_list_model_get_n_items (G_LIST_MODEL (self->model)) : 0;
   gtk_list_item_manager_remove_items (self, NULL, 0, n_items);
+  /* recycled widgets were set up by the old factory */
+  gtk_list_item_manager_clear_recycled (self);
 
   g_set_object (&self->factory, factory);
 
@@ -902,6 +1086,9 @@ gtk_list_item_manager_get_model (GtkListItemManager *self)
  * Creates a list item widget to use for @position. No widget may
  * yet exist that is used for @position.
  *
+ * If a previously released widget is available for recycling, it is
+ * used instead, which avoids running the factory's setup again.
+ *
  * When the returned item is no longer needed, the caller is responsible
  * for calling gtk_list_item_manager_release_list_item().  
  * A particular case is when the row at @position is removed. In that case,
@@ -922,8 +1109,26 @@ gtk_list_item_manager_acquire_list_item (GtkListItemManager *self,
   g_return_val_if_fail (GTK_IS_LIST_ITEM_MANAGER (self), NULL);
   g_return_val_if_fail (prev_sibling == NULL || GTK_IS_WIDGET (prev_sibling), NULL);
 
-  result = gtk_list_item_widget_new (self->factory,
-                                     self->item_css_name);
+  result = g_queue_pop_head (&self->recycled);
+  if (result)
+    {
+      gtk_widget_set_child_visible (result, TRUE);
+      gtk_css_node_set_visible (gtk_widget_get_css_node (result),
+                                gtk_widget_get_visible (result));
+      recycled_list_items++;
+    }
+  else
+    {
+      result = gtk_list_item_widget_new (self->factory,
+                                         self->item_css_name);
+      created_list_items++;
+    }
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_set_int_counter (created_list_items_counter, created_list_items);
+      gdk_profiler_set_int_counter (recycled_list_items_counter, recycled_list_items);
+    }
 
   gtk_list_item_widget_set_single_click_activate (GTK_LIST_ITEM_WIDGET (result), self->single_click_activate);
 
@@ -1073,7 +1278,54 @@ gtk_list_item_manager_release_list_item (GtkListItemManager *self,
       return;
     }
 
-  gtk_widget_unparent (item);
+  gtk_list_item_manager_recycle_list_item (self, item);
+}
+
+/*
+ * gtk_list_item_manager_recycle_list_item:
+ * @self: a #GtkListItemManager
+ * @item: a list item that is no longer in use
+ *
+ * Unbinds @item and keeps it around hidden, so that it can be returned
+ * from gtk_list_item_manager_acquire_list_item() later. If too many
+ * items are kept already, @item is destroyed instead.
+ **/
+static void
+gtk_list_item_manager_recycle_list_item (GtkListItemManager *self,
+                                         GtkWidget          *item)
+{
+  if (self->recycled.length >= GTK_LIST_VIEW_MAX_RECYCLED_ITEMS ||
+      _gtk_widget_get_parent (item) != self->widget ||
+      (gtk_widget_get_state_flags (item) & GTK_STATE_FLAG_FOCUS_WITHIN))
+    {
+      gtk_widget_unparent (item);
+      return;
+    }
+
+  gtk_list_item_widget_update (GTK_LIST_ITEM_WIDGET (item),
+                               GTK_INVALID_LIST_POSITION,
+                               NULL,
+                               FALSE);
+  gtk_widget_set_child_visible (item, FALSE);
+  /* Keep pooled items from matching :first-child and friends in place
+   * of the real rows */
+  gtk_css_node_set_visible (gtk_widget_get_css_node (item), FALSE);
+  g_queue_push_tail (&self->recycled, item);
+}
+
+static void
+gtk_list_item_manager_recycle_change (GtkListItemManager *self,
+                                      GHashTable         *change)
+{
+  GHashTableIter iter;
+  gpointer widget;
+
+  g_hash_table_iter_init (&iter, change);
+  while (g_hash_table_iter_next (&iter, NULL, &widget))
+    {
+      g_hash_table_iter_steal (&iter);
+      gtk_list_item_manager_recycle_list_item (self, widget);
+    }
 }
 
 void
@@ -1123,6 +1375,8 @@ void
 gtk_list_item_tracker_free (GtkListItemManager *self,
                             GtkListItemTracker *tracker)
 {
+  gtk_list_item_manager_flush_changes (self);
+
   gtk_list_item_tracker_unset_position (self, tracker);
 
   self->trackers = g_slist_remove (self->trackers, tracker);
@@ -1144,6 +1398,8 @@ gtk_list_item_tracker_set_position (GtkListItemManager *self,
   GtkListItemManagerItem *item;
   guint n_items;
 
+  gtk_list_item_manager_flush_changes (self);
+
   gtk_list_item_tracker_unset_position (self, tracker);
 
   if (self->model == NULL)
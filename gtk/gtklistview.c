@@ -39,6 +39,10 @@
 /* Extra items to keep above + below every tracker */
 #define GTK_LIST_VIEW_EXTRA_ITEMS 2
 
+/* Number of measured rows after which the estimate for rows
+ * without a widget turns into a moving average */
+#define GTK_LIST_VIEW_MAX_MEASURED_ROWS 1000
+
 /**
  * SECTION:gtklistview
  * @title: GtkListView
@@ -147,6 +151,11 @@ struct _GtkListView
   gboolean show_separators;
 
   int list_width;
+
+  /* statistics of all row heights seen so far, used to estimate
+   * the height of rows that don't have a widget */
+  guint n_measured_rows;
+  guint64 measured_rows_height;
 };
 
 struct _GtkListViewClass
@@ -158,6 +167,7 @@ struct _ListRow
 {
   GtkListItemManagerItem parent;
   guint height; /* per row */
+  gboolean measured; /* height is included in the statistics */
 };
 
 struct _ListRowAugment
@@ -480,6 +490,61 @@ gtk_list_view_get_unknown_row_height (GtkListView *self,
   return g_array_index (heights, int, heights->len / 2);
 }
 
+static void
+gtk_list_view_add_row_height (GtkListView *self,
+                              guint        height)
+{
+  if (self->n_measured_rows < GTK_LIST_VIEW_MAX_MEASURED_ROWS)
+    self->n_measured_rows++;
+  else
+    self->measured_rows_height -= self->measured_rows_height / self->n_measured_rows;
+
+  self->measured_rows_height += height;
+}
+
+static void
+gtk_list_view_change_row_height (GtkListView *self,
+                                 guint        old_height,
+                                 guint        new_height)
+{
+  /* Once we use a moving average, the old height has decayed by an
+   * unknown amount, so count the new height as a new row instead. */
+  if (self->n_measured_rows >= GTK_LIST_VIEW_MAX_MEASURED_ROWS)
+    {
+      gtk_list_view_add_row_height (self, new_height);
+      return;
+    }
+
+  self->measured_rows_height -= MIN (old_height, self->measured_rows_height);
+  self->measured_rows_height += new_height;
+}
+
+static void
+gtk_list_view_reset_row_heights (GtkListView *self)
+{
+  ListRow *row;
+
+  self->n_measured_rows = 0;
+  self->measured_rows_height = 0;
+
+  for (row = gtk_list_item_manager_get_first (self->item_manager);
+       row != NULL;
+       row = gtk_rb_tree_node_get_next (row))
+    row->measured = FALSE;
+}
+
+/* Unlike the median of the currently visible rows, the average of all
+ * rows seen so far changes only slowly while scrolling, so the
+ * estimated list height and with it the scrollbar stays stable. */
+static guint
+gtk_list_view_get_estimated_row_height (GtkListView *self)
+{
+  if (self->n_measured_rows == 0)
+    return 0;
+
+  return (self->measured_rows_height + self->n_measured_rows / 2) / self->n_measured_rows;
+}
+
 static void
 gtk_list_view_measure_across (GtkWidget      *widget,
                               GtkOrientation  orientation,
@@ -527,7 +592,7 @@ gtk_list_view_measure_list (GtkWidget      *widget,
   ListRow *row;
   int min, nat, child_min, child_nat;
   GArray *min_heights, *nat_heights;
-  guint n_unknown;
+  guint n_unknown, row_height;
 
   min_heights = g_array_new (FALSE, FALSE, sizeof (int));
   nat_heights = g_array_new (FALSE, FALSE, sizeof (int));
@@ -557,8 +622,19 @@ gtk_list_view_measure_list (GtkWidget      *widget,
 
   if (n_unknown)
     {
-      min += n_unknown * gtk_list_view_get_unknown_row_height (self, min_heights);
-      nat += n_unknown * gtk_list_view_get_unknown_row_height (self, nat_heights);
+      /* Use the same estimate as size_allocate(), so the list doesn't
+       * request a different height than it lays out. */
+      if (self->n_measured_rows > 0)
+        {
+          row_height = gtk_list_view_get_estimated_row_height (self);
+          min += n_unknown * row_height;
+          nat += n_unknown * row_height;
+        }
+      else
+        {
+          min += n_unknown * gtk_list_view_get_unknown_row_height (self, min_heights);
+          nat += n_unknown * gtk_list_view_get_unknown_row_height (self, nat_heights);
+        }
     }
   g_array_free (min_heights, TRUE);
   g_array_free (nat_heights, TRUE);
@@ -592,7 +668,6 @@ gtk_list_view_size_allocate (GtkWidget *widget,
 {
   GtkListView *self = GTK_LIST_VIEW (widget);
   ListRow *row;
-  GArray *heights;
   int min, nat, row_height;
   int x, y;
   GtkOrientation orientation, opposite_orientation;
@@ -617,8 +692,6 @@ gtk_list_view_size_allocate (GtkWidget *widget,
     self->list_width = MAX (nat, self->list_width);
 
   /* step 2: determine height of known list items */
-  heights = g_array_new (FALSE, FALSE, sizeof (int));
-
   for (row = gtk_list_item_manager_get_first (self->item_manager);
        row != NULL;
        row = gtk_rb_tree_node_get_next (row))
@@ -633,17 +706,24 @@ gtk_list_view_size_allocate (GtkWidget *widget,
         row_height = min;
       else
         row_height = nat;
+      if (!row->measured)
+        {
+          gtk_list_view_add_row_height (self, row_height);
+          row->measured = TRUE;
+        }
+      else if (row->height != row_height)
+        {
+          gtk_list_view_change_row_height (self, row->height, row_height);
+        }
       if (row->height != row_height)
         {
           row->height = row_height;
           gtk_rb_tree_node_mark_dirty (row);
         }
-      g_array_append_val (heights, row_height);
     }
 
   /* step 3: determine height of unknown items */
-  row_height = gtk_list_view_get_unknown_row_height (self, heights);
-  g_array_free (heights, TRUE);
+  row_height = gtk_list_view_get_estimated_row_height (self);
 
   for (row = gtk_list_item_manager_get_first (self->item_manager);
        row != NULL;
@@ -652,6 +732,7 @@ gtk_list_view_size_allocate (GtkWidget *widget,
       if (row->parent.widget)
         continue;
 
+      row->measured = FALSE;
       if (row->height != row_height)
         {
           row->height = row_height;
@@ -1000,6 +1081,8 @@ gtk_list_view_set_model (GtkListView       *self,
   if (!gtk_list_base_set_model (GTK_LIST_BASE (self), model))
     return;
 
+  gtk_list_view_reset_row_heights (self);
+
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MODEL]);
 }
 
@@ -1037,6 +1120,7 @@ gtk_list_view_set_factory (GtkListView        *self,
     return;
 
   gtk_list_item_manager_set_factory (self->item_manager, factory);
+  gtk_list_view_reset_row_heights (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_FACTORY]);
 }
@@ -25,6 +25,11 @@
 
 #include <string.h>
 
+/* Statistics for all caches, exported for GtkInspector */
+static guint cache_hits;
+static guint cache_misses;
+static guint caches_grown;
+
 void
 _gtk_size_request_cache_init (SizeRequestCache *cache)
 {
@@ -32,34 +37,36 @@ _gtk_size_request_cache_init (SizeRequestCache *cache)
 }
 
 static void
-free_sizes_x (SizeRequestX **sizes)
+free_sizes_x (SizeRequestX **sizes,
+              guint          n_sizes)
 {
-  int i;
+  guint i;
 
-  for (i = 0; i < GTK_SIZE_REQUEST_CACHED_SIZES && sizes[i] != NULL; i++)
+  for (i = 0; i < n_sizes; i++)
     g_slice_free (SizeRequestX, sizes[i]);
 
-  g_slice_free1 (sizeof (SizeRequestY *) * GTK_SIZE_REQUEST_CACHED_SIZES, sizes);
+  g_free (sizes);
 }
 
 static void
-free_sizes_y (SizeRequestY **sizes)
+free_sizes_y (SizeRequestY **sizes,
+              guint          n_sizes)
 {
-  int i;
+  guint i;
 
-  for (i = 0; i < GTK_SIZE_REQUEST_CACHED_SIZES && sizes[i] != NULL; i++)
+  for (i = 0; i < n_sizes; i++)
     g_slice_free (SizeRequestY, sizes[i]);
 
-  g_slice_free1 (sizeof (SizeRequestY *) * GTK_SIZE_REQUEST_CACHED_SIZES, sizes);
+  g_free (sizes);
 }
 
 void
 _gtk_size_request_cache_free (SizeRequestCache *cache)
 {
   if (cache->requests_x)
-    free_sizes_x (cache->requests_x);
+    free_sizes_x (cache->requests_x, cache->flags[GTK_ORIENTATION_HORIZONTAL].n_cached_requests);
   if (cache->requests_y)
-    free_sizes_y (cache->requests_y);
+    free_sizes_y (cache->requests_y, cache->flags[GTK_ORIENTATION_VERTICAL].n_cached_requests);
 }
 
 void
@@ -69,6 +76,39 @@ _gtk_size_request_cache_clear (SizeRequestCache *cache)
   _gtk_size_request_cache_init (cache);
 }
 
+/* Picks the slot for a new entry and stores it in last_cached_request.
+ *
+ * The request arrays start out with room for GTK_SIZE_REQUEST_CACHED_SIZES
+ * entries. Once a widget fills them, it is likely to be measured for many
+ * sizes, so the array is grown to GTK_SIZE_REQUEST_MAX_CACHED_SIZES instead
+ * of recycling entries. Returns %TRUE if the array needs to be grown.
+ */
+static gboolean
+next_cached_request (SizeRequestCache *cache,
+                     GtkOrientation    orientation)
+{
+  guint n_sizes = cache->flags[orientation].n_cached_requests;
+
+  if (n_sizes < GTK_SIZE_REQUEST_MAX_CACHED_SIZES)
+    {
+      cache->flags[orientation].n_cached_requests++;
+      cache->flags[orientation].last_cached_request = n_sizes;
+
+      if (n_sizes == GTK_SIZE_REQUEST_CACHED_SIZES)
+        {
+          caches_grown++;
+          return TRUE;
+        }
+    }
+  else
+    {
+      if (++cache->flags[orientation].last_cached_request == n_sizes)
+        cache->flags[orientation].last_cached_request = 0;
+    }
+
+  return FALSE;
+}
+
 void
 _gtk_size_request_cache_commit (SizeRequestCache *cache,
                                 GtkOrientation    orientation,
@@ -132,21 +172,13 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
       /* If not found, pull a new size from the cache, the returned size cache
        * will immediately be used to cache the new computed size so we go ahead
        * and increment the last_cached_request right away */
-      if (n_sizes < GTK_SIZE_REQUEST_CACHED_SIZES)
-	{
-	  cache->flags[orientation].n_cached_requests++;
-	  cache->flags[orientation].last_cached_request = cache->flags[orientation].n_cached_requests - 1;
-	}
-      else
-	{
-	  if (++cache->flags[orientation].last_cached_request == GTK_SIZE_REQUEST_CACHED_SIZES)
-	    cache->flags[orientation].last_cached_request = 0;
-	}
+      if (next_cached_request (cache, orientation))
+        cache->requests_x = g_renew (SizeRequestX *, cache->requests_x, GTK_SIZE_REQUEST_MAX_CACHED_SIZES);
 
       if (cache->requests_x == NULL)
-	cache->requests_x = g_slice_alloc0 (sizeof (SizeRequestX *) * GTK_SIZE_REQUEST_CACHED_SIZES);
+	cache->requests_x = g_new (SizeRequestX *, GTK_SIZE_REQUEST_CACHED_SIZES);
 
-      if (cache->requests_x[cache->flags[orientation].last_cached_request] == NULL)
+      if (cache->flags[orientation].last_cached_request >= n_sizes)
 	cache->requests_x[cache->flags[orientation].last_cached_request] = g_slice_new (SizeRequestX);
 
       cached_size = cache->requests_x[cache->flags[orientation].last_cached_request];
@@ -176,21 +208,13 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
       /* If not found, pull a new size from the cache, the returned size cache
        * will immediately be used to cache the new computed size so we go ahead
        * and increment the last_cached_request right away */
-      if (n_sizes < GTK_SIZE_REQUEST_CACHED_SIZES)
-	{
-	  cache->flags[orientation].n_cached_requests++;
-	  cache->flags[orientation].last_cached_request = cache->flags[orientation].n_cached_requests - 1;
-	}
-      else
-	{
-	  if (++cache->flags[orientation].last_cached_request == GTK_SIZE_REQUEST_CACHED_SIZES)
-	    cache->flags[orientation].last_cached_request = 0;
-	}
+      if (next_cached_request (cache, orientation))
+        cache->requests_y = g_renew (SizeRequestY *, cache->requests_y, GTK_SIZE_REQUEST_MAX_CACHED_SIZES);
 
       if (cache->requests_y == NULL)
-	cache->requests_y = g_slice_alloc0 (sizeof (SizeRequestY *) * GTK_SIZE_REQUEST_CACHED_SIZES);
+	cache->requests_y = g_new (SizeRequestY *, GTK_SIZE_REQUEST_CACHED_SIZES);
 
-      if (cache->requests_y[cache->flags[orientation].last_cached_request] == NULL)
+      if (cache->flags[orientation].last_cached_request >= n_sizes)
 	cache->requests_y[cache->flags[orientation].last_cached_request] = g_slice_new (SizeRequestY);
 
       cached_size = cache->requests_y[cache->flags[orientation].last_cached_request];
@@ -208,14 +232,14 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
  * Note that this caching code was originally derived from
  * the Clutter toolkit but has evolved for other GTK requirements.
  */
-gboolean
-_gtk_size_request_cache_lookup (const SizeRequestCache *cache,
-                                GtkOrientation          orientation,
-                                int                     for_size,
-                                int                    *minimum,
-                                int                    *natural,
-                                int                    *minimum_baseline,
-                                int                    *natural_baseline)
+static gboolean
+gtk_size_request_cache_lookup_internal (const SizeRequestCache *cache,
+                                        GtkOrientation          orientation,
+                                        int                     for_size,
+                                        int                    *minimum,
+                                        int                    *natural,
+                                        int                    *minimum_baseline,
+                                        int                    *natural_baseline)
 {
   guint i, p;
 
@@ -298,3 +322,35 @@ _gtk_size_request_cache_lookup (const SizeRequestCache *cache,
     }
 }
 
+gboolean
+_gtk_size_request_cache_lookup (const SizeRequestCache *cache,
+                                GtkOrientation          orientation,
+                                int                     for_size,
+                                int                    *minimum,
+                                int                    *natural,
+                                int                    *minimum_baseline,
+                                int                    *natural_baseline)
+{
+  if (gtk_size_request_cache_lookup_internal (cache, orientation, for_size,
+                                              minimum, natural,
+                                              minimum_baseline, natural_baseline))
+    {
+      cache_hits++;
+      return TRUE;
+    }
+
+  cache_misses++;
+  return FALSE;
+}
+
+/* This is exported privately for use in GtkInspector.
+ */
+void
+_gtk_size_request_cache_get_statistics (guint *hits,
+                                        guint *misses,
+                                        guint *grown)
+{
+  *hits = cache_hits;
+  *misses = cache_misses;
+  *grown = caches_grown;
+}
@@ -38,6 +38,12 @@ G_BEGIN_DECLS
  */
 #define GTK_SIZE_REQUEST_CACHED_SIZES   (5)
 
+/* Widgets that keep getting measured for more distinct
+ * sizes than that, like wrapping labels in a grid, get
+ * their cache grown to this many entries once it is full.
+ */
+#define GTK_SIZE_REQUEST_MAX_CACHED_SIZES (16)
+
 typedef struct {
   int minimum_size;
   int natural_size;
@@ -74,8 +80,8 @@ typedef struct {
   GtkSizeRequestMode request_mode   : 3;
   guint       request_mode_valid    : 1;
   struct {
-    guint       n_cached_requests   : 3;
-    guint       last_cached_request : 3;
+    guint       n_cached_requests   : 5;
+    guint       last_cached_request : 5;
     guint       cached_size_valid   : 1;
   }           flags[2];
 } SizeRequestCache;
@@ -99,6 +105,10 @@ gboolean        _gtk_size_request_cache_lookup                  (const SizeReque
                                                                  int                    *minimum_baseline,
                                                                  int                    *natural_baseline);
 
+void            _gtk_size_request_cache_get_statistics          (guint                  *hits,
+                                                                 guint                  *misses,
+                                                                 guint                  *grown);
+
 G_END_DECLS
 
 #endif /* __GTK_SIZE_REQUEST_CACHE_PRIVATE_H__ */
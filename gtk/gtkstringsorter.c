@@ -135,6 +135,20 @@ struct _GtkStringSortKeys
   gboolean ignore_case;
 };
 
+/* The first bytes of the collation key are stored inline in the key, in
+ * big-endian order, so that most comparisons in the sort are integer
+ * comparisons that don't need to look at the string at all.
+ * The full key is only consulted when the prefixes are equal.
+ */
+#define GTK_STRING_SORT_KEY_PREFIX_WORDS 2
+
+typedef struct _GtkStringSortKey GtkStringSortKey;
+struct _GtkStringSortKey
+{
+  guint64 prefix[GTK_STRING_SORT_KEY_PREFIX_WORDS];
+  char *key;
+};
+
 static void
 gtk_string_sort_keys_free (GtkSortKeys *keys)
 {
@@ -149,15 +163,27 @@ gtk_string_sort_keys_compare (gconstpointer a,
                               gconstpointer b,
                               gpointer      unused)
 {
-  const char *sa = *(const char **) a;
-  const char *sb = *(const char **) b;
+  const GtkStringSortKey *ka = a;
+  const GtkStringSortKey *kb = b;
+  guint i;
 
-  if (sa == NULL)
-    return sb == NULL ? GTK_ORDERING_EQUAL : GTK_ORDERING_LARGER;
-  else if (sb == NULL)
+  if (ka->key == NULL)
+    return kb->key == NULL ? GTK_ORDERING_EQUAL : GTK_ORDERING_LARGER;
+  else if (kb->key == NULL)
     return GTK_ORDERING_SMALLER;
 
-  return gtk_ordering_from_cmpfunc (strcmp (sa, sb));
+  for (i = 0; i < GTK_STRING_SORT_KEY_PREFIX_WORDS; i++)
+    {
+      if (ka->prefix[i] != kb->prefix[i])
+        return ka->prefix[i] < kb->prefix[i] ? GTK_ORDERING_SMALLER : GTK_ORDERING_LARGER;
+    }
+
+  /* Both keys ended inside the prefix, so they are identical */
+  if ((ka->prefix[GTK_STRING_SORT_KEY_PREFIX_WORDS - 1] & 0xff) == 0)
+    return GTK_ORDERING_EQUAL;
+
+  return gtk_ordering_from_cmpfunc (strcmp (ka->key + sizeof (ka->prefix),
+                                            kb->key + sizeof (kb->prefix)));
 }
 
 static gboolean
@@ -173,18 +199,36 @@ gtk_string_sort_keys_init_key (GtkSortKeys *keys,
                                gpointer     key_memory)
 {
   GtkStringSortKeys *self = (GtkStringSortKeys *) keys;
-  char **key = (char **) key_memory;
+  GtkStringSortKey *key = (GtkStringSortKey *) key_memory;
+  char bytes[sizeof (key->prefix)];
+  guint i;
+
+  key->key = gtk_string_sorter_get_key (self->expression, self->ignore_case, item);
+  if (key->key == NULL)
+    {
+      memset (key->prefix, 0, sizeof (key->prefix));
+      return;
+    }
 
-  *key = gtk_string_sorter_get_key (self->expression, self->ignore_case, item);
+  /* strncpy() pads with nuls, so short keys compare before longer ones */
+  strncpy (bytes, key->key, sizeof (bytes));
+
+  for (i = 0; i < GTK_STRING_SORT_KEY_PREFIX_WORDS; i++)
+    {
+      guint64 word;
+
+      memcpy (&word, bytes + i * sizeof (guint64), sizeof (guint64));
+      key->prefix[i] = GUINT64_FROM_BE (word);
+    }
 }
 
 static void
 gtk_string_sort_keys_clear_key (GtkSortKeys *keys,
                                 gpointer     key_memory)
 {
-  char **key = (char **) key_memory;
+  GtkStringSortKey *key = (GtkStringSortKey *) key_memory;
 
-  g_free (*key);
+  g_free (key->key);
 }
 
 static const GtkSortKeysClass GTK_STRING_SORT_KEYS_CLASS =
@@ -206,8 +250,8 @@ gtk_string_sort_keys_new (GtkStringSorter *self)
 
   result = gtk_sort_keys_new (GtkStringSortKeys,
                               &GTK_STRING_SORT_KEYS_CLASS,
-                              sizeof (char *),
-                              sizeof (char *));
+                              sizeof (GtkStringSortKey),
+                              G_ALIGNOF (GtkStringSortKey));
 
   result->expression = gtk_expression_ref (self->expression);
   result->ignore_case = self->ignore_case;
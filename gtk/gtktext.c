@@ -2082,6 +2082,11 @@ gtk_text_get_display_text (GtkText *self,
 
   if (end_pos <= start_pos)
       return g_strdup ("");
+  else if (priv->visible && start_pos == 0 && end_pos == length)
+    {
+      /* Avoid walking the whole text to find its end */
+      return g_strndup (text, gtk_entry_buffer_get_bytes (get_buffer (self)));
+    }
   else if (priv->visible)
     {
       start = g_utf8_offset_to_pointer (text, start_pos);
@@ -4364,9 +4369,13 @@ gtk_text_recompute (GtkText *self)
     return;
 
   gtk_text_check_cursor_blink (self);
-  gtk_text_adjust_scroll (self);
-  update_im_cursor_location (self);
-  gtk_text_update_handles (self);
+
+  /* Scrolling to the cursor and placing the IM window and text
+   * handles all need a new layout. Leave them to the next size
+   * allocation, so that several changes within one frame, like
+   * repeated keys, only lay out the text once.
+   */
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
 }
 
 static PangoLayout *
@@ -1090,6 +1090,49 @@ _gtk_text_btree_delete (GtkTextIter *start,
   gtk_text_btree_resolve_bidi (start, end);
 }
 
+/* Same as pango_find_paragraph_boundary(), but only looks at the
+ * bytes that can start a paragraph delimiter instead of decoding
+ * every character, which matters when inserting large texts.
+ */
+static void
+find_paragraph_boundary (const char *text,
+                         int         length,
+                         int        *paragraph_delimiter_index,
+                         int        *next_paragraph_start)
+{
+  const guchar *p = (const guchar *) text;
+  const guchar *end = p + length;
+
+  for (; p < end; p++)
+    {
+      if (*p == '\n')
+        {
+          *paragraph_delimiter_index = p - (const guchar *) text;
+          *next_paragraph_start = *paragraph_delimiter_index + 1;
+          return;
+        }
+      else if (*p == '\r')
+        {
+          *paragraph_delimiter_index = p - (const guchar *) text;
+          if (p + 1 < end && p[1] == '\n')
+            *next_paragraph_start = *paragraph_delimiter_index + 2;
+          else
+            *next_paragraph_start = *paragraph_delimiter_index + 1;
+          return;
+        }
+      else if (*p == 0xe2 && end - p >= 3 && p[1] == 0x80 && p[2] == 0xa9)
+        {
+          /* U+2029 PARAGRAPH SEPARATOR */
+          *paragraph_delimiter_index = p - (const guchar *) text;
+          *next_paragraph_start = *paragraph_delimiter_index + 3;
+          return;
+        }
+    }
+
+  *paragraph_delimiter_index = length;
+  *next_paragraph_start = length;
+}
+
 void
 _gtk_text_btree_insert (GtkTextIter *iter,
                         const char *text,
@@ -1160,10 +1203,10 @@ _gtk_text_btree_insert (GtkTextIter *iter,
     {
       sol = eol;
       
-      pango_find_paragraph_boundary (text + sol,
-                                     len - sol,
-                                     &delim,
-                                     &eol);      
+      find_paragraph_boundary (text + sol,
+                               len - sol,
+                               &delim,
+                               &eol);
 
       /* make these relative to the start of the text */
       delim += sol;
@@ -1177,7 +1220,7 @@ _gtk_text_btree_insert (GtkTextIter *iter,
       
       chunk_len = eol - sol;
 
-      g_assert (g_utf8_validate (&text[sol], chunk_len, NULL));
+      /* The text has been validated by the buffer already */
       seg = _gtk_char_segment_new (&text[sol], chunk_len);
 
       char_count_delta += seg->char_count;
@@ -1806,8 +1849,6 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
 
   tree = _gtk_text_iter_get_btree (&start);
 
-  queue_tag_redisplay (tree, tag, &start, &end);
-
   info = gtk_text_btree_get_tag_info (tree, tag);
 
   start_line = _gtk_text_iter_get_text_line (&start);
@@ -1842,6 +1883,17 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
    */
 
   toggled_on = gtk_text_iter_has_tag (&start, tag);
+
+  /* If the tag is already in the wanted state over the whole range,
+   * there is nothing to change. Highlighters tend to reapply the same
+   * tags over and over, so avoid invalidating the layout for them.
+   */
+  if (stack->count == 0 && (add ? toggled_on : !toggled_on))
+    {
+      iter_stack_free (stack);
+      return;
+    }
+
   if ( (add && !toggled_on) ||
        (!add && toggled_on) )
     {
@@ -2015,6 +2067,9 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
 
   segments_changed (tree);
 
+  /* Tagging doesn't add or remove lines, so invalidating the range
+   * once, after the change, covers the old and the new state.
+   */
   queue_tag_redisplay (tree, tag, &start, &end);
 
 #ifdef G_ENABLE_DEBUG
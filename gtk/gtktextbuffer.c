@@ -5016,3 +5016,43 @@ gtk_text_buffer_set_max_undo_levels (GtkTextBuffer *buffer,
 
   gtk_text_history_set_max_undo_levels (buffer->priv->history, max_undo_levels);
 }
+
+/**
+ * gtk_text_buffer_get_max_undo_bytes:
+ * @buffer: a #GtkTextBuffer
+ *
+ * Gets the maximum amount of inserted or removed text, in bytes, that
+ * is kept for undo. If 0, the amount is not limited.
+ *
+ * Returns: the maximum number of bytes kept for undo
+ */
+gsize
+gtk_text_buffer_get_max_undo_bytes (GtkTextBuffer *buffer)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), 0);
+
+  return gtk_text_history_get_max_undo_bytes (buffer->priv->history);
+}
+
+/**
+ * gtk_text_buffer_set_max_undo_bytes:
+ * @buffer: a #GtkTextBuffer
+ * @max_undo_bytes: the maximum number of bytes to keep for undo
+ *
+ * Sets the maximum amount of inserted or removed text, in bytes, that
+ * is kept for undo. When it is exceeded, the oldest undo actions are
+ * dropped, but the most recent one is always kept. If 0, the amount
+ * is not limited.
+ *
+ * This limits the memory used by the undo history when large amounts
+ * of text are pasted or replaced, which the number of undo levels
+ * set with gtk_text_buffer_set_max_undo_levels() does not.
+ */
+void
+gtk_text_buffer_set_max_undo_bytes (GtkTextBuffer *buffer,
+                                    gsize          max_undo_bytes)
+{
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+
+  gtk_text_history_set_max_undo_bytes (buffer->priv->history, max_undo_bytes);
+}
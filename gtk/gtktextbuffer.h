@@ -472,6 +472,11 @@ GDK_AVAILABLE_IN_ALL
 void            gtk_text_buffer_set_max_undo_levels       (GtkTextBuffer *buffer,
                                                            guint          max_undo_levels);
 GDK_AVAILABLE_IN_ALL
+gsize           gtk_text_buffer_get_max_undo_bytes        (GtkTextBuffer *buffer);
+GDK_AVAILABLE_IN_ALL
+void            gtk_text_buffer_set_max_undo_bytes        (GtkTextBuffer *buffer,
+                                                           gsize          max_undo_bytes);
+GDK_AVAILABLE_IN_ALL
 void            gtk_text_buffer_undo                      (GtkTextBuffer *buffer);
 GDK_AVAILABLE_IN_ALL
 void            gtk_text_buffer_redo                      (GtkTextBuffer *buffer);
@@ -36,6 +36,12 @@
  * gtk_text_history_end_irreversible_action() can be used to denote a
  * section of operations that cannot be undone. This will cause all previous
  * changes tracked by the GtkTextHistory to be discarded.
+ *
+ * Besides the number of undo levels, the history can be limited by the
+ * amount of text it keeps (see gtk_text_history_set_max_undo_bytes()),
+ * which is unlimited by default. The oldest actions are dropped first, but
+ * the most recent action is always kept so that a single large paste can
+ * still be undone.
  */
 
 typedef struct _Action     Action;
@@ -99,6 +105,10 @@ struct _GtkTextHistory
   guint               in_user;
   guint               max_undo_levels;
 
+  /* Bytes of text held by the actions in both queues */
+  gsize               n_bytes;
+  gsize               max_undo_bytes;
+
   guint               can_undo : 1;
   guint               can_redo : 1;
   guint               is_modified : 1;
@@ -180,6 +190,34 @@ action_free (Action *action)
   g_slice_free (Action, action);
 }
 
+static gsize
+action_get_n_bytes (const Action *action)
+{
+  const GList *iter;
+  gsize n_bytes = 0;
+
+  switch (action->kind)
+    {
+    case ACTION_KIND_INSERT:
+      return action->u.insert.istr.n_bytes;
+
+    case ACTION_KIND_DELETE_BACKSPACE:
+    case ACTION_KIND_DELETE_KEY:
+    case ACTION_KIND_DELETE_PROGRAMMATIC:
+    case ACTION_KIND_DELETE_SELECTION:
+      return action->u.delete.istr.n_bytes;
+
+    case ACTION_KIND_GROUP:
+      for (iter = action->u.group.actions.head; iter; iter = iter->next)
+        n_bytes += action_get_n_bytes (iter->data);
+      return n_bytes;
+
+    case ACTION_KIND_BARRIER:
+    default:
+      return 0;
+    }
+}
+
 static gboolean
 action_group_is_empty (const Action *action)
 {
@@ -334,6 +372,28 @@ action_chain (Action   *action,
     }
 }
 
+static void
+gtk_text_history_drop_action (GtkTextHistory *self,
+                              GQueue         *queue,
+                              Action         *action)
+{
+  gsize n_bytes = action_get_n_bytes (action);
+
+  g_assert (self->n_bytes >= n_bytes);
+
+  self->n_bytes -= n_bytes;
+  g_queue_unlink (queue, &action->link);
+  action_free (action);
+}
+
+static void
+gtk_text_history_clear_queue (GtkTextHistory *self,
+                              GQueue         *queue)
+{
+  while (queue->length > 0)
+    gtk_text_history_drop_action (self, queue, g_queue_peek_head (queue));
+}
+
 static void
 gtk_text_history_do_change_state (GtkTextHistory *self,
                                   gboolean        is_modified,
@@ -388,17 +448,9 @@ static void
 gtk_text_history_truncate_one (GtkTextHistory *self)
 {
   if (self->undo_queue.length > 0)
-    {
-      Action *action = g_queue_peek_head (&self->undo_queue);
-      g_queue_unlink (&self->undo_queue, &action->link);
-      action_free (action);
-    }
+    gtk_text_history_drop_action (self, &self->undo_queue, g_queue_peek_head (&self->undo_queue));
   else if (self->redo_queue.length > 0)
-    {
-      Action *action = g_queue_peek_tail (&self->redo_queue);
-      g_queue_unlink (&self->redo_queue, &action->link);
-      action_free (action);
-    }
+    gtk_text_history_drop_action (self, &self->redo_queue, g_queue_peek_tail (&self->redo_queue));
   else
     {
       g_assert_not_reached ();
@@ -410,11 +462,28 @@ gtk_text_history_truncate (GtkTextHistory *self)
 {
   g_assert (GTK_IS_TEXT_HISTORY (self));
 
-  if (self->max_undo_levels == 0)
-    return;
+  if (self->max_undo_levels > 0)
+    {
+      while (self->undo_queue.length + self->redo_queue.length > self->max_undo_levels)
+        gtk_text_history_truncate_one (self);
+    }
 
-  while (self->undo_queue.length + self->redo_queue.length > self->max_undo_levels)
-    gtk_text_history_truncate_one (self);
+  /* The limit covers both queues, so drop from them in the same order
+   * as gtk_text_history_truncate_one(). Never drop the most recent undo
+   * action, it may be a group that is still being filled by a user action.
+   */
+  if (self->max_undo_bytes > 0)
+    {
+      while (self->n_bytes > self->max_undo_bytes)
+        {
+          if (self->undo_queue.length > 1)
+            gtk_text_history_drop_action (self, &self->undo_queue, g_queue_peek_head (&self->undo_queue));
+          else if (self->redo_queue.length > 0)
+            gtk_text_history_drop_action (self, &self->redo_queue, g_queue_peek_tail (&self->redo_queue));
+          else
+            break;
+        }
+    }
 }
 
 static void
@@ -498,12 +567,10 @@ gtk_text_history_push (GtkTextHistory *self,
   g_assert (self->enabled);
   g_assert (action != NULL);
 
-  while (self->redo_queue.length > 0)
-    {
-      peek = g_queue_peek_head (&self->redo_queue);
-      g_queue_unlink (&self->redo_queue, &peek->link);
-      action_free (peek);
-    }
+  gtk_text_history_clear_queue (self, &self->redo_queue);
+
+  /* The action may be freed when chaining, so account for it first */
+  self->n_bytes += action_get_n_bytes (action);
 
   peek = g_queue_peek_tail (&self->undo_queue);
   in_user_action = self->in_user > 0;
@@ -791,7 +858,7 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
   return_if_applying (self);
   return_if_irreversible (self);
 
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear_queue (self, &self->redo_queue);
 
   peek = g_queue_peek_tail (&self->undo_queue);
 
@@ -813,8 +880,7 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
   /* Unlikely, but if the group is empty, just remove it */
   if (action_group_is_empty (peek))
     {
-      g_queue_unlink (&self->undo_queue, &peek->link);
-      action_free (peek);
+      gtk_text_history_drop_action (self, &self->undo_queue, peek);
       goto update_state;
     }
 
@@ -843,8 +909,8 @@ gtk_text_history_begin_irreversible_action (GtkTextHistory *self)
 
   self->irreversible++;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear_queue (self, &self->undo_queue);
+  gtk_text_history_clear_queue (self, &self->redo_queue);
 
   gtk_text_history_update_state (self);
 }
@@ -865,8 +931,8 @@ gtk_text_history_end_irreversible_action (GtkTextHistory *self)
 
   self->irreversible--;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear_queue (self, &self->undo_queue);
+  gtk_text_history_clear_queue (self, &self->redo_queue);
 
   gtk_text_history_update_state (self);
 }
@@ -1034,8 +1100,8 @@ gtk_text_history_set_enabled (GtkTextHistory *self,
         {
           self->irreversible = 0;
           self->in_user = 0;
-          clear_action_queue (&self->undo_queue);
-          clear_action_queue (&self->redo_queue);
+          gtk_text_history_clear_queue (self, &self->undo_queue);
+          gtk_text_history_clear_queue (self, &self->redo_queue);
         }
 
       gtk_text_history_update_state (self);
@@ -1062,3 +1128,25 @@ gtk_text_history_set_max_undo_levels (GtkTextHistory *self,
       gtk_text_history_truncate (self);
     }
 }
+
+gsize
+gtk_text_history_get_max_undo_bytes (GtkTextHistory *self)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_HISTORY (self), 0);
+
+  return self->max_undo_bytes;
+}
+
+void
+gtk_text_history_set_max_undo_bytes (GtkTextHistory *self,
+                                     gsize           max_undo_bytes)
+{
+  g_return_if_fail (GTK_IS_TEXT_HISTORY (self));
+
+  if (self->max_undo_bytes != max_undo_bytes)
+    {
+      self->max_undo_bytes = max_undo_bytes;
+      gtk_text_history_truncate (self);
+      gtk_text_history_update_state (self);
+    }
+}
@@ -4654,6 +4654,30 @@ utf8_caselessnmatch (const char *s1,
   return ret;
 }
 
+/* Checks whether the text of @line can contain the byte @c, looking
+ * at the char segments in place. Other segments with a byte count,
+ * such as paintables and child anchors, may show up as U+FFFC.
+ */
+static gboolean
+line_may_contain_byte (GtkTextLine *line,
+                       guchar       c)
+{
+  GtkTextLineSegment *seg;
+
+  for (seg = line->segments; seg != NULL; seg = seg->next)
+    {
+      if (seg->type == &gtk_text_char_type)
+        {
+          if (memchr (seg->body.chars, c, seg->byte_count) != NULL)
+            return TRUE;
+        }
+      else if (seg->byte_count > 0)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 static gboolean
 lines_match (const GtkTextIter *start,
              const char **lines,
@@ -4878,6 +4902,7 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
   gboolean visible_only;
   gboolean slice;
   gboolean case_insensitive;
+  guchar first_byte;
 
   g_return_val_if_fail (iter != NULL, FALSE);
   g_return_val_if_fail (str != NULL, FALSE);
@@ -4915,6 +4940,16 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
 
   lines = strbreakup (str, "\n", -1, NULL, case_insensitive);
 
+  /* A match has to start on a line containing the first byte of
+   * the search string, which lets us skip other lines without
+   * getting their text. Casefolding doesn't preserve bytes, so
+   * this only works for case-sensitive searches.
+   */
+  if (case_insensitive)
+    first_byte = 0;
+  else
+    first_byte = lines[0][0];
+
   search = *iter;
 
   do
@@ -4928,7 +4963,11 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
       if (limit &&
           gtk_text_iter_compare (&search, limit) >= 0)
         break;
-      
+
+      if (first_byte != 0 &&
+          !line_may_contain_byte (_gtk_text_iter_get_text_line (&search), first_byte))
+        continue;
+
       if (lines_match (&search, (const char **)lines,
                        visible_only, slice, case_insensitive, &match, &end))
         {
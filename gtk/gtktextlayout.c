@@ -3899,6 +3899,7 @@ static void
 render_para (GskPangoRenderer   *crenderer,
              int                 offset_y,
              GtkTextLineDisplay *line_display,
+             const GdkRGBA      *selection,
              int                 selection_start_index,
              int                 selection_end_index,
              float               cursor_alpha)
@@ -3908,7 +3909,6 @@ render_para (GskPangoRenderer   *crenderer,
   int byte_offset = 0;
   PangoLayoutIter *iter;
   int screen_width;
-  const GdkRGBA *selection = NULL;
   gboolean first = TRUE;
 
   g_return_if_fail (GTK_IS_TEXT_VIEW (crenderer->widget));
@@ -3917,15 +3917,6 @@ render_para (GskPangoRenderer   *crenderer,
   screen_width = line_display->total_width;
 
   context = _gtk_widget_get_style_context (crenderer->widget);
-  if (selection_start_index != -1 || selection_end_index != -1)
-    {
-      GtkCssNode *selection_node = gtk_text_view_get_selection_node ((GtkTextView*)crenderer->widget);
-      gtk_style_context_save_to_node (context, selection_node);
-
-      selection = gtk_css_color_value_get_rgba (_gtk_style_context_peek_property (context, GTK_CSS_PROPERTY_BACKGROUND_COLOR));
-
-      gtk_style_context_restore (context);
-    }
 
   if (offset_y)
     {
@@ -4111,6 +4102,22 @@ render_para (GskPangoRenderer   *crenderer,
   pango_layout_iter_free (iter);
 }
 
+static gboolean
+line_display_node_is_valid (GtkTextLineDisplay *line_display,
+                            const GdkRGBA      *selection,
+                            int                 selection_start_index,
+                            int                 selection_end_index)
+{
+  if (line_display->node_selection_start != selection_start_index ||
+      line_display->node_selection_end != selection_end_index)
+    return FALSE;
+
+  if (selection_start_index == -1 && selection_end_index == -1)
+    return TRUE;
+
+  return gdk_rgba_equal (&line_display->node_selection_rgba, selection);
+}
+
 static gboolean
 snapshot_shape (PangoAttrShape         *attr,
                 GdkSnapshot            *snapshot,
@@ -4144,6 +4151,7 @@ gtk_text_layout_snapshot (GtkTextLayout      *layout,
   GSList *line_list;
   GSList *tmp_list;
   GdkRGBA color;
+  GdkRGBA selection = { 0, };
 
   g_return_if_fail (GTK_IS_TEXT_LAYOUT (layout));
   g_return_if_fail (layout->default_style != NULL);
@@ -4177,8 +4185,14 @@ gtk_text_layout_snapshot (GtkTextLayout      *layout,
                                                          &selection_end);
   if (have_selection)
     {
+      GtkCssNode *selection_node = gtk_text_view_get_selection_node ((GtkTextView*)widget);
+
       selection_start_line = gtk_text_iter_get_line (&selection_start);
       selection_end_line = gtk_text_iter_get_line (&selection_end);
+
+      gtk_style_context_save_to_node (context, selection_node);
+      selection = *gtk_css_color_value_get_rgba (_gtk_style_context_peek_property (context, GTK_CSS_PROPERTY_BACKGROUND_COLOR));
+      gtk_style_context_restore (context);
     }
   else
     {
@@ -4236,14 +4250,35 @@ gtk_text_layout_snapshot (GtkTextLayout      *layout,
                 selection_end_index = -1;
             }
 
-          if (line_display->node == NULL)
+          /* The block cursor blinks and depends on the focus, so
+           * lines showing it are not cached.
+           */
+          if (line_display->has_block_cursor)
             {
-              gtk_snapshot_push_collect (snapshot);
-              render_para (crenderer, 0, line_display,
-                           selection_start_index, selection_end_index,
+              g_clear_pointer (&line_display->node, gsk_render_node_unref);
+              render_para (crenderer, offset_y, line_display,
+                           &selection, selection_start_index, selection_end_index,
                            cursor_alpha);
+            }
+          else
+            {
+              if (line_display->node != NULL &&
+                  !line_display_node_is_valid (line_display, &selection,
+                                               selection_start_index, selection_end_index))
+                g_clear_pointer (&line_display->node, gsk_render_node_unref);
 
-              line_display->node = gtk_snapshot_pop_collect (snapshot);
+              if (line_display->node == NULL)
+                {
+                  gtk_snapshot_push_collect (snapshot);
+                  render_para (crenderer, 0, line_display,
+                               &selection, selection_start_index, selection_end_index,
+                               cursor_alpha);
+
+                  line_display->node = gtk_snapshot_pop_collect (snapshot);
+                  line_display->node_selection_start = selection_start_index;
+                  line_display->node_selection_end = selection_end_index;
+                  line_display->node_selection_rgba = selection;
+                }
             }
 
           if (line_display->node != NULL)
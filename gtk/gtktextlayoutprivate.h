@@ -186,7 +186,12 @@ struct _GtkTextLineDisplay
 {
   PangoLayout *layout;
 
+  /* Text and selection of the line, without cursors */
   GskRenderNode *node;
+  /* The selection @node was rendered with */
+  int node_selection_start;
+  int node_selection_end;
+  GdkRGBA node_selection_rgba;
 
   GArray *cursors;      /* indexes of cursors in the PangoLayout, and mark names */
 
@@ -233,8 +233,9 @@ gtk_text_line_display_cache_invalidate_display (GtkTextLineDisplayCache *cache,
 
   if (cursors_only)
     {
+      /* The render node does not contain the cursors, and is
+       * checked against the selection when snapshotting. */
       g_clear_pointer (&display->cursors, g_array_unref);
-      g_clear_pointer (&display->node, gsk_render_node_unref);
       display->cursors_invalid = TRUE;
       display->has_block_cursor = FALSE;
     }
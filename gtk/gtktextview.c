@@ -145,6 +145,9 @@
 
 #define SPACE_FOR_CURSOR 1
 
+/* How long incremental validation may run per idle, in microseconds */
+#define INCREMENTAL_VALIDATE_BUDGET 5000
+
 typedef struct _GtkTextWindow GtkTextWindow;
 typedef struct _GtkTextPendingScroll GtkTextPendingScroll;
 
@@ -4662,10 +4665,21 @@ incremental_validate_callback (gpointer data)
 {
   GtkTextView *text_view = data;
   gboolean result = TRUE;
+  gint64 end_time;
 
   DV(g_print(G_STRLOC"\n"));
-  
-  gtk_text_layout_validate (text_view->priv->layout, 2000);
+
+  /* Validate in chunks for as long as the budget allows, so that
+   * large buffers don't need an idle dispatch and an adjustment
+   * update for every 2000 pixels.
+   */
+  end_time = g_get_monotonic_time () + INCREMENTAL_VALIDATE_BUDGET;
+  do
+    {
+      gtk_text_layout_validate (text_view->priv->layout, 2000);
+    }
+  while (!gtk_text_layout_is_valid (text_view->priv->layout) &&
+         g_get_monotonic_time () < end_time);
 
   gtk_text_view_update_adjustments (text_view);
   
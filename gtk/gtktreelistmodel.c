@@ -38,6 +38,7 @@
 enum {
   PROP_0,
   PROP_AUTOEXPAND,
+  PROP_LAZY_AUTOEXPAND,
   PROP_MODEL,
   PROP_PASSTHROUGH,
   NUM_PROPERTIES
@@ -58,6 +59,10 @@ struct _TreeNode
 
   guint empty : 1;
   guint is_root : 1;
+  /* collapsed via gtk_tree_list_row_set_expanded() */
+  guint collapsed : 1;
+  /* queued in the list's pending_expand for lazy autoexpanding */
+  guint expand_requested : 1;
 };
 
 struct _TreeAugment
@@ -76,7 +81,11 @@ struct _GtkTreeListModel
   gpointer user_data;
   GDestroyNotify user_destroy;
 
+  GPtrArray *pending_expand;
+  guint pending_expand_id;
+
   guint autoexpand : 1;
+  guint lazy_autoexpand : 1;
   guint passthrough : 1;
 };
 
@@ -99,6 +108,18 @@ struct _GtkTreeListRowClass
 
 static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
 
+enum {
+  ROW_PROP_0,
+  ROW_PROP_CHILDREN,
+  ROW_PROP_DEPTH,
+  ROW_PROP_EXPANDABLE,
+  ROW_PROP_EXPANDED,
+  ROW_PROP_ITEM,
+  NUM_ROW_PROPERTIES
+};
+
+static GParamSpec *row_properties[NUM_ROW_PROPERTIES] = { NULL, };
+
 static GtkTreeListModel *
 tree_node_get_tree_list_model (TreeNode *node)
 {
@@ -363,6 +384,103 @@ static guint
 gtk_tree_list_model_expand_node (GtkTreeListModel *self,
                                  TreeNode         *node);
 
+/* Expands a newly added node if the model autoexpands.
+ * Returns the number of items that were added */
+static guint
+gtk_tree_list_model_autoexpand_node (GtkTreeListModel *self,
+                                     TreeNode         *node)
+{
+  if (!self->autoexpand)
+    return 0;
+
+  /* will be expanded in tree_node_request_expand() */
+  if (self->lazy_autoexpand)
+    return 0;
+
+  return gtk_tree_list_model_expand_node (self, node);
+}
+
+static gboolean
+tree_node_wants_lazy_expand (GtkTreeListModel *self,
+                             TreeNode         *node)
+{
+  return self->autoexpand &&
+         self->lazy_autoexpand &&
+         node->model == NULL &&
+         !node->empty &&
+         !node->collapsed;
+}
+
+static void
+tree_node_cancel_expand (GtkTreeListModel *self,
+                         TreeNode         *node)
+{
+  if (!node->expand_requested)
+    return;
+
+  g_ptr_array_remove_fast (self->pending_expand, node);
+  node->expand_requested = FALSE;
+}
+
+static gboolean
+gtk_tree_list_model_expand_pending_cb (gpointer data)
+{
+  GtkTreeListModel *self = data;
+
+  g_object_ref (self);
+
+  /* Emitting items-changed will make views look at the new rows, which
+   * may queue more nodes, so take them one at a time */
+  while (self->pending_expand->len > 0)
+    {
+      TreeNode *node;
+      guint n_items;
+
+      node = g_ptr_array_remove_index_fast (self->pending_expand, self->pending_expand->len - 1);
+      node->expand_requested = FALSE;
+
+      if (!tree_node_wants_lazy_expand (self, node))
+        continue;
+
+      n_items = gtk_tree_list_model_expand_node (self, node);
+      if (n_items > 0)
+        g_list_model_items_changed (G_LIST_MODEL (self), tree_node_get_position (node) + 1, 0, n_items);
+      if (node->row)
+        {
+          g_object_notify_by_pspec (G_OBJECT (node->row), row_properties[ROW_PROP_EXPANDED]);
+          g_object_notify_by_pspec (G_OBJECT (node->row), row_properties[ROW_PROP_CHILDREN]);
+        }
+    }
+
+  self->pending_expand_id = 0;
+  g_object_unref (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Called when @node is handed out. If it should be autoexpanded, do
+ * that now. We can't emit items-changed from inside get_item(), so
+ * queue it instead. */
+static void
+tree_node_request_expand (GtkTreeListModel *self,
+                          TreeNode         *node)
+{
+  if (node->expand_requested || !tree_node_wants_lazy_expand (self, node))
+    return;
+
+  node->expand_requested = TRUE;
+  g_ptr_array_add (self->pending_expand, node);
+
+  if (self->pending_expand_id == 0)
+    {
+      self->pending_expand_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+                                                 gtk_tree_list_model_expand_pending_cb,
+                                                 self,
+                                                 NULL);
+      g_source_set_name_by_id (self->pending_expand_id, "[gtk] gtk_tree_list_model_expand_pending_cb");
+    }
+}
+
 static void
 gtk_tree_list_model_items_changed_cb (GListModel *model,
                                       guint       position,
@@ -425,7 +543,7 @@ gtk_tree_list_model_items_changed_cb (GListModel *model,
     {
       for (i = 0; i < added; i++)
         {
-          tree_added += gtk_tree_list_model_expand_node (self, child);
+          tree_added += gtk_tree_list_model_autoexpand_node (self, child);
           child = gtk_rb_tree_node_get_next (child);
         }
     }
@@ -445,6 +563,9 @@ gtk_tree_list_model_clear_node (gpointer data)
 {
   TreeNode *node = data;
 
+  if (node->expand_requested)
+    tree_node_cancel_expand (tree_node_get_tree_list_model (node), node);
+
   if (node->row)
     gtk_tree_list_row_destroy (node->row);
 
@@ -511,8 +632,7 @@ gtk_tree_list_model_init_node (GtkTreeListModel *list,
     {
       node = gtk_rb_tree_insert_after (self->children, node);
       node->parent = self;
-      if (list->autoexpand)
-        gtk_tree_list_model_expand_node (list, node);
+      gtk_tree_list_model_autoexpand_node (list, node);
     }
 }
 
@@ -522,6 +642,8 @@ gtk_tree_list_model_expand_node (GtkTreeListModel *self,
 {
   GListModel *model;
 
+  tree_node_cancel_expand (self, node);
+
   if (node->empty)
     return 0;
   
@@ -546,6 +668,8 @@ gtk_tree_list_model_collapse_node (GtkTreeListModel *self,
 {      
   guint n_items;
 
+  tree_node_cancel_expand (self, node);
+
   if (node->model == NULL)
     return 0;
 
@@ -590,6 +714,8 @@ gtk_tree_list_model_get_item (GListModel *list,
   if (node == NULL)
     return NULL;
 
+  tree_node_request_expand (self, node);
+
   if (self->passthrough)
     {
       return tree_node_get_item (node);
@@ -625,6 +751,10 @@ gtk_tree_list_model_set_property (GObject      *object,
       gtk_tree_list_model_set_autoexpand (self, g_value_get_boolean (value));
       break;
 
+    case PROP_LAZY_AUTOEXPAND:
+      gtk_tree_list_model_set_lazy_autoexpand (self, g_value_get_boolean (value));
+      break;
+
     case PROP_PASSTHROUGH:
       self->passthrough = g_value_get_boolean (value);
       break;
@@ -649,6 +779,10 @@ gtk_tree_list_model_get_property (GObject     *object,
       g_value_set_boolean (value, self->autoexpand);
       break;
 
+    case PROP_LAZY_AUTOEXPAND:
+      g_value_set_boolean (value, self->lazy_autoexpand);
+      break;
+
     case PROP_MODEL:
       g_value_set_object (value, self->root_node.model);
       break;
@@ -669,6 +803,8 @@ gtk_tree_list_model_finalize (GObject *object)
   GtkTreeListModel *self = GTK_TREE_LIST_MODEL (object);
 
   gtk_tree_list_model_clear_node (&self->root_node);
+  g_clear_handle_id (&self->pending_expand_id, g_source_remove);
+  g_ptr_array_unref (self->pending_expand);
   if (self->user_destroy)
     self->user_destroy (self->user_data);
 
@@ -696,6 +832,18 @@ gtk_tree_list_model_class_init (GtkTreeListModelClass *class)
                             FALSE,
                             GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkTreeListModel:lazy-autoexpand:
+   *
+   * If autoexpanded rows should only be expanded once they are looked at
+   */
+  properties[PROP_LAZY_AUTOEXPAND] =
+      g_param_spec_boolean ("lazy-autoexpand",
+                            P_("lazy autoexpand"),
+                            P_("If rows should only be autoexpanded when they are looked at"),
+                            FALSE,
+                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   /**
    * GtkTreeListModel:model:
    *
@@ -730,6 +878,7 @@ gtk_tree_list_model_init (GtkTreeListModel *self)
 {
   self->root_node.list = self;
   self->root_node.is_root = TRUE;
+  self->pending_expand = g_ptr_array_new ();
 }
 
 /**
@@ -835,6 +984,56 @@ gtk_tree_list_model_set_autoexpand (GtkTreeListModel *self,
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_AUTOEXPAND]);
 }
 
+/**
+ * gtk_tree_list_model_set_lazy_autoexpand:
+ * @self: a #GtkTreeListModel
+ * @lazy_autoexpand: %TRUE to only autoexpand rows when they are looked at
+ *
+ * If set to %TRUE, #GtkTreeListModel:autoexpand does not expand rows
+ * when they are added. Instead rows are expanded once their item is
+ * retrieved via g_list_model_get_item() or gtk_tree_list_model_get_row(),
+ * which is when a list widget shows them. Their children are added to
+ * the model in a later main loop iteration.
+ *
+ * This avoids creating the child models of the whole tree up front
+ * for deep trees. Rows that were collapsed with
+ * gtk_tree_list_row_set_expanded() are not expanded again.
+ *
+ * Unlike with non-lazy autoexpanding, this also applies to rows that
+ * exist already, so to lazily expand the whole tree, create the model
+ * with autoexpand set to %FALSE and enable both properties afterwards.
+ **/
+void
+gtk_tree_list_model_set_lazy_autoexpand (GtkTreeListModel *self,
+                                         gboolean          lazy_autoexpand)
+{
+  g_return_if_fail (GTK_IS_TREE_LIST_MODEL (self));
+
+  if (self->lazy_autoexpand == lazy_autoexpand)
+    return;
+
+  self->lazy_autoexpand = lazy_autoexpand;
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LAZY_AUTOEXPAND]);
+}
+
+/**
+ * gtk_tree_list_model_get_lazy_autoexpand:
+ * @self: a #GtkTreeListModel
+ *
+ * Gets whether autoexpanded rows are only expanded once they are
+ * looked at. See gtk_tree_list_model_set_lazy_autoexpand().
+ *
+ * Returns: %TRUE if the model expands rows lazily
+ **/
+gboolean
+gtk_tree_list_model_get_lazy_autoexpand (GtkTreeListModel *self)
+{
+  g_return_val_if_fail (GTK_IS_TREE_LIST_MODEL (self), FALSE);
+
+  return self->lazy_autoexpand;
+}
+
 /**
  * gtk_tree_list_model_get_autoexpand:
  * @self: a #GtkTreeListModel
@@ -887,6 +1086,8 @@ gtk_tree_list_model_get_row (GtkTreeListModel *self,
   if (node == NULL)
     return NULL;
 
+  tree_node_request_expand (self, node);
+
   return tree_node_get_row (node);
 }
 
@@ -939,18 +1140,6 @@ gtk_tree_list_model_get_child_row (GtkTreeListModel *self,
  * it possible to sort trees properly.
  */
 
-enum {
-  ROW_PROP_0,
-  ROW_PROP_CHILDREN,
-  ROW_PROP_DEPTH,
-  ROW_PROP_EXPANDABLE,
-  ROW_PROP_EXPANDED,
-  ROW_PROP_ITEM,
-  NUM_ROW_PROPERTIES
-};
-
-static GParamSpec *row_properties[NUM_ROW_PROPERTIES] = { NULL, };
-
 G_DEFINE_TYPE (GtkTreeListRow, gtk_tree_list_row, G_TYPE_OBJECT)
 
 static void
@@ -1192,6 +1381,8 @@ gtk_tree_list_row_set_expanded (GtkTreeListRow *self,
   if (self->node == NULL)
     return;
 
+  self->node->collapsed = !expanded;
+
   was_expanded = self->node->children != NULL;
   if (was_expanded == expanded)
     return;
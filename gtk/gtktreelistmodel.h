@@ -74,6 +74,11 @@ void                    gtk_tree_list_model_set_autoexpand      (GtkTreeListMode
                                                                  gboolean                autoexpand);
 GDK_AVAILABLE_IN_ALL
 gboolean                gtk_tree_list_model_get_autoexpand      (GtkTreeListModel       *self);
+GDK_AVAILABLE_IN_ALL
+void                    gtk_tree_list_model_set_lazy_autoexpand (GtkTreeListModel       *self,
+                                                                 gboolean                lazy_autoexpand);
+GDK_AVAILABLE_IN_ALL
+gboolean                gtk_tree_list_model_get_lazy_autoexpand (GtkTreeListModel       *self);
 
 GDK_AVAILABLE_IN_ALL
 GtkTreeListRow *        gtk_tree_list_model_get_child_row       (GtkTreeListModel       *self,
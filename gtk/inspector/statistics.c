@@ -32,6 +32,8 @@
 #include "gtkeventcontrollerkey.h"
 #include "gtkmain.h"
 #include "gtkliststore.h"
+#include "gtkcssnodeprivate.h"
+#include "gtksizerequestcacheprivate.h"
 
 #include <glib/gi18n-lib.h>
 
@@ -61,6 +63,10 @@ struct _GtkInspectorStatisticsPrivate
   guint update_source_id;
   GtkWidget *search_entry;
   GtkWidget *search_bar;
+  GtkWidget *css_cache;
+  GtkWidget *css_validation;
+  GtkWidget *size_request_cache;
+  guint update_counters_id;
 };
 
 typedef struct {
@@ -132,6 +138,62 @@ add_type_count (GtkInspectorStatistics *sl, GType type)
   return cumulative;
 }
 
+static void
+update_css_cache (GtkInspectorStatistics *sl)
+{
+  guint hits, misses;
+  char *text;
+
+  gtk_css_node_get_style_cache_statistics (&hits, &misses);
+
+  text = g_strdup_printf (_("CSS style cache: %u hits, %u misses"), hits, misses);
+  gtk_label_set_text (GTK_LABEL (sl->priv->css_cache), text);
+  g_free (text);
+}
+
+static void
+update_css_validation (GtkInspectorStatistics *sl)
+{
+  guint invalidated, created, hits, misses;
+  char *text;
+
+  gtk_css_node_get_validation_statistics (&invalidated, &created, &hits, &misses);
+
+  text = g_strdup_printf (_("Last CSS validation: %u nodes invalidated, %u styles created, %u cache hits, %u cache misses"),
+                          invalidated, created, hits, misses);
+  gtk_label_set_text (GTK_LABEL (sl->priv->css_validation), text);
+  g_free (text);
+}
+
+static void
+update_size_request_cache (GtkInspectorStatistics *sl)
+{
+  guint hits, misses, grown;
+  char *text;
+
+  _gtk_size_request_cache_get_statistics (&hits, &misses, &grown);
+
+  text = g_strdup_printf (_("Size request cache: %u hits, %u misses, %u caches grown"),
+                          hits, misses, grown);
+  gtk_label_set_text (GTK_LABEL (sl->priv->size_request_cache), text);
+  g_free (text);
+}
+
+/* Unlike the type counts, these counters don't need GLib's
+ * instance counting, so they are always shown and updated.
+ */
+static gboolean
+update_counters (gpointer data)
+{
+  GtkInspectorStatistics *sl = data;
+
+  update_css_cache (sl);
+  update_css_validation (sl);
+  update_size_request_cache (sl);
+
+  return G_SOURCE_CONTINUE;
+}
+
 static gboolean
 update_type_counts (gpointer data)
 {
@@ -346,6 +408,27 @@ root (GtkWidget *widget)
   gtk_search_bar_set_key_capture_widget (GTK_SEARCH_BAR (sl->priv->search_bar), toplevel);
 }
 
+static void
+map (GtkWidget *widget)
+{
+  GtkInspectorStatistics *sl = GTK_INSPECTOR_STATISTICS (widget);
+
+  GTK_WIDGET_CLASS (gtk_inspector_statistics_parent_class)->map (widget);
+
+  update_counters (sl);
+  sl->priv->update_counters_id = g_timeout_add_seconds (1, update_counters, sl);
+}
+
+static void
+unmap (GtkWidget *widget)
+{
+  GtkInspectorStatistics *sl = GTK_INSPECTOR_STATISTICS (widget);
+
+  g_clear_handle_id (&sl->priv->update_counters_id, g_source_remove);
+
+  GTK_WIDGET_CLASS (gtk_inspector_statistics_parent_class)->unmap (widget);
+}
+
 static void
 unroot (GtkWidget *widget)
 {
@@ -469,6 +552,8 @@ gtk_inspector_statistics_class_init (GtkInspectorStatisticsClass *klass)
 
   widget_class->root = root;
   widget_class->unroot = unroot;
+  widget_class->map = map;
+  widget_class->unmap = unmap;
 
   g_object_class_install_property (object_class, PROP_BUTTON,
       g_param_spec_object ("button", NULL, NULL,
@@ -489,6 +574,9 @@ gtk_inspector_statistics_class_init (GtkInspectorStatisticsClass *klass)
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, search_entry);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, search_bar);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, excuse);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, css_cache);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, css_validation);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, size_request_cache);
 
 }
 
@@ -0,0 +1,117 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "frame-stats.h"
+
+/* Toggles a style class on the window every frame, which forces
+ * all the CSS nodes below it to be restyled. Together with the
+ * frame statistics (or the "css validation" profiler mark), this
+ * measures how long a full-window restyle takes.
+ */
+
+static int n_rows = 2000;
+static int n_columns = 10;
+
+static const char css[] =
+  "window.restyle label { color: red; }\n"
+  "window.restyle box:nth-child(even) label { color: blue; }\n";
+
+static gboolean
+toggle_class (GtkWidget     *window,
+              GdkFrameClock *frame_clock,
+              gpointer       user_data)
+{
+  if (gtk_widget_has_css_class (window, "restyle"))
+    gtk_widget_remove_css_class (window, "restyle");
+  else
+    gtk_widget_add_css_class (window, "restyle");
+
+  return G_SOURCE_CONTINUE;
+}
+
+static GOptionEntry options[] = {
+  { "rows", 'r', 0, G_OPTION_ARG_INT, &n_rows, "Number of rows", "COUNT" },
+  { "columns", 'c', 0, G_OPTION_ARG_INT, &n_columns, "Number of labels per row", "COUNT" },
+  { NULL }
+};
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window;
+  GtkWidget *scrolled_window;
+  GtkWidget *vbox;
+  GtkCssProvider *provider;
+  GError *error = NULL;
+  int i, j;
+  gboolean done = FALSE;
+
+  GOptionContext *context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+
+  gtk_init ();
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, css, -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+  g_object_unref (provider);
+
+  window = gtk_window_new ();
+  frame_stats_ensure (GTK_WINDOW (window));
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+
+  scrolled_window = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), scrolled_window);
+
+  vbox = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (scrolled_window), vbox);
+
+  for (i = 0; i < n_rows; i++)
+    {
+      GtkWidget *hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+
+      for (j = 0; j < n_columns; j++)
+        {
+          char *text = g_strdup_printf ("%d:%d", i, j);
+          gtk_box_append (GTK_BOX (hbox), gtk_label_new (text));
+          g_free (text);
+        }
+
+      gtk_box_append (GTK_BOX (vbox), hbox);
+    }
+
+  gtk_widget_add_tick_callback (window,
+                                toggle_class,
+                                NULL,
+                                NULL);
+
+  gtk_widget_show (window);
+  g_signal_connect (window, "destroy",
+                    G_CALLBACK (quit_cb), &done);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
@@ -44,6 +44,7 @@ enum {
   SELECT,
   CHECK_SELECT,
   SET_MAX_UNDO,
+  SET_MAX_UNDO_BYTES,
 };
 
 typedef struct
@@ -314,6 +315,10 @@ run_test (const Command *commands,
           gtk_text_history_set_max_undo_levels (text->history, cmd->location);
           break;
 
+        case SET_MAX_UNDO_BYTES:
+          gtk_text_history_set_max_undo_bytes (text->history, cmd->location);
+          break;
+
         default:
           break;
         }
@@ -578,6 +583,43 @@ test13 (void)
   run_test (commands, G_N_ELEMENTS (commands), 3);
 }
 
+static void
+test14 (void)
+{
+  /* The oldest action is dropped once the text exceeds the byte limit */
+  static const Command commands[] = {
+    { SET_MAX_UNDO_BYTES, 8 },
+    { BEGIN_USER }, { INSERT, 0, -1, "abcd", "abcd" }, { END_USER },
+    { BEGIN_USER }, { INSERT, 4, -1, "efgh", "abcdefgh" }, { END_USER },
+    { BEGIN_USER }, { INSERT, 8, -1, "ijkl", "abcdefghijkl" }, { END_USER },
+    { UNDO, -1, -1, NULL, "abcdefgh", SET, SET, UNSET },
+    { UNDO, -1, -1, NULL, "abcd", UNSET, SET, UNSET },
+    { UNDO, -1, -1, NULL, "abcd", UNSET, SET, UNSET },
+    { REDO, -1, -1, NULL, "abcdefgh", SET, SET, UNSET },
+    { REDO, -1, -1, NULL, "abcdefghijkl", SET, UNSET, UNSET },
+  };
+
+  run_test (commands, G_N_ELEMENTS (commands), 0);
+}
+
+static void
+test15 (void)
+{
+  /* Redo actions count against the byte limit, the furthest one is dropped */
+  static const Command commands[] = {
+    { BEGIN_USER }, { INSERT, 0, -1, "abcd", "abcd" }, { END_USER },
+    { BEGIN_USER }, { INSERT, 4, -1, "efgh", "abcdefgh" }, { END_USER },
+    { BEGIN_USER }, { INSERT, 8, -1, "ijkl", "abcdefghijkl" }, { END_USER },
+    { UNDO, -1, -1, NULL, "abcdefgh", SET, SET, UNSET },
+    { UNDO, -1, -1, NULL, "abcd", SET, SET, UNSET },
+    { SET_MAX_UNDO_BYTES, 8, -1, NULL, "abcd", SET, SET, UNSET },
+    { REDO, -1, -1, NULL, "abcdefgh", SET, UNSET, UNSET },
+    { REDO, -1, -1, NULL, "abcdefgh", SET, UNSET, UNSET },
+  };
+
+  run_test (commands, G_N_ELEMENTS (commands), 0);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -596,5 +638,7 @@ main (int   argc,
   g_test_add_func ("/Gtk/TextHistory/test11", test11);
   g_test_add_func ("/Gtk/TextHistory/test12", test12);
   g_test_add_func ("/Gtk/TextHistory/test13", test13);
+  g_test_add_func ("/Gtk/TextHistory/test14", test14);
+  g_test_add_func ("/Gtk/TextHistory/test15", test15);
   return g_test_run ();
 }
@@ -0,0 +1,184 @@
+#include <gtk/gtk.h>
+
+static void
+assert_color (GtkWidget  *widget,
+              const char *expected)
+{
+  GdkRGBA color, expected_color;
+
+  gtk_style_context_get_color (gtk_widget_get_style_context (widget), &color);
+  gdk_rgba_parse (&expected_color, expected);
+
+  g_assert_true (gdk_rgba_equal (&color, &expected_color));
+}
+
+/* Name, class and id selectors are looked up in an index, while
+ * other selectors are tried for every node. Check that both find
+ * the right rules. In debug builds, every match is also checked
+ * against trying all selectors.
+ */
+static void
+test_match_selectors (void)
+{
+  GtkCssProvider *provider;
+  GtkWidget *box, *label, *classed, *named, *compound, *other;
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider,
+                                   "* { color: black; }\n"
+                                   "label { color: red; }\n"
+                                   ".match { color: green; }\n"
+                                   "#match { color: blue; }\n"
+                                   "label.compound { color: yellow; }\n"
+                                   ".unused { color: white; }\n"
+                                   "box > :not(label) { color: gray; }\n",
+                                   -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_USER);
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  g_object_ref_sink (box);
+
+  label = gtk_label_new ("Label");
+  gtk_box_append (GTK_BOX (box), label);
+
+  classed = gtk_label_new ("Label");
+  gtk_widget_add_css_class (classed, "match");
+  gtk_box_append (GTK_BOX (box), classed);
+
+  named = gtk_label_new ("Label");
+  gtk_widget_set_name (named, "match");
+  gtk_widget_add_css_class (named, "match");
+  gtk_box_append (GTK_BOX (box), named);
+
+  compound = gtk_label_new ("Label");
+  gtk_widget_add_css_class (compound, "compound");
+  gtk_box_append (GTK_BOX (box), compound);
+
+  other = gtk_image_new ();
+  gtk_box_append (GTK_BOX (box), other);
+
+  assert_color (box, "black");
+  assert_color (label, "red");
+  assert_color (classed, "green");
+  assert_color (named, "blue");
+  assert_color (compound, "yellow");
+  assert_color (other, "gray");
+
+  /* Changing classes must pick up the rules for the new class */
+  gtk_widget_remove_css_class (classed, "match");
+  gtk_widget_add_css_class (compound, "match");
+  gtk_widget_add_css_class (other, "match");
+  assert_color (classed, "red");
+  assert_color (compound, "yellow");
+  assert_color (other, "green");
+
+  g_object_unref (box);
+  gtk_style_context_remove_provider_for_display (gdk_display_get_default (),
+                                                 GTK_STYLE_PROVIDER (provider));
+  g_object_unref (provider);
+}
+
+static GtkWidget *
+create_widgets (guint n)
+{
+  GtkWidget *window, *box;
+  guint i;
+
+  window = gtk_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_window_set_child (GTK_WINDOW (window), box);
+
+  for (i = 0; i < n; i++)
+    {
+      GtkWidget *child;
+
+      switch (i % 4)
+        {
+        case 0:
+          child = gtk_button_new_with_label ("Button");
+          break;
+        case 1:
+          child = gtk_label_new ("Label");
+          gtk_widget_add_css_class (child, "dim-label");
+          break;
+        case 2:
+          child = gtk_entry_new ();
+          break;
+        default:
+          child = gtk_check_button_new_with_label ("Check");
+          break;
+        }
+
+      gtk_box_append (GTK_BOX (box), child);
+    }
+
+  return window;
+}
+
+static guint
+update_styles (GtkWidget *widget)
+{
+  GtkWidget *child;
+  GdkRGBA color;
+  guint n = 1;
+
+  gtk_style_context_get_color (gtk_widget_get_style_context (widget), &color);
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    n += update_styles (child);
+
+  return n;
+}
+
+/* Restyles a window full of widgets using the built-in theme,
+ * which makes every node go through selector matching again.
+ */
+static void
+test_match_theme (void)
+{
+  guint n = g_test_perf () ? 10000 : 100;
+  guint n_iterations = g_test_perf () ? 20 : 2;
+  GtkWidget *window;
+  guint i, n_nodes = 0;
+  double elapsed;
+
+  g_object_set (gtk_settings_get_default (), "gtk-theme-name", "Adwaita", NULL);
+
+  window = create_widgets (n);
+  update_styles (window);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      /* Adwaita has lots of :backdrop rules, so this affects all widgets */
+      if (i % 2)
+        gtk_widget_unset_state_flags (window, GTK_STATE_FLAG_BACKDROP);
+      else
+        gtk_widget_set_state_flags (window, GTK_STATE_FLAG_BACKDROP, FALSE);
+
+      n_nodes += update_styles (window);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_maximized_result (n_nodes / elapsed, "matching %u nodes against Adwaita: %g nodes/sec",
+                             n_nodes, n_nodes / elapsed);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/css/match/selectors", test_match_selectors);
+  g_test_add_func ("/css/match/theme", test_match_theme);
+
+  return g_test_run ();
+}
@@ -0,0 +1,137 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include "../../gtk/css/gtkcsstokenizerprivate.h"
+
+/* Pairs of CSS that must produce the same tokens. The first one
+ * takes the tokenizer's fast paths, the second one uses escapes
+ * to force the slow paths.
+ */
+static const struct {
+  const char *fast;
+  const char *slow;
+} token_tests[] = {
+  /* identifiers */
+  { "foo", "f\\6f o" },
+  { "foo-bar_baz", "foo\\-bar_baz" },
+  { "-foo --bar", "-f\\6f o --b\\61 r" },
+  { "gr\xc3\xbc\xc3\x9f" "e", "gr\\fc \\df e" },
+  /* functions, at-keywords and hashes */
+  { "rgba(1,2,3)", "rgb\\61(1,2,3)" },
+  { "@import", "@imp\\6frt" },
+  { "#header", "#h\\65 ader" },
+  /* numbers and dimensions */
+  { "12px 1.5em -3e2ms 50%", "12p\\78  1.5e\\6d  -3e2m\\73  50%" },
+  /* whitespace */
+  { "a \t\n  b", "a b" },
+  /* strings */
+  { "'foo bar'", "'foo\\20 bar'" },
+  { "\"a'b\"", "\"a\\'b\"" },
+  { "'abc", "'a\\62 c" },
+};
+
+static void
+test_tokenizer_fast_paths (void)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (token_tests); i++)
+    {
+      GtkCssTokenizer *fast, *slow;
+      GtkCssToken fast_token, slow_token;
+      GBytes *bytes;
+      guint n_tokens = 0;
+
+      bytes = g_bytes_new_static (token_tests[i].fast, strlen (token_tests[i].fast));
+      fast = gtk_css_tokenizer_new (bytes);
+      g_bytes_unref (bytes);
+      bytes = g_bytes_new_static (token_tests[i].slow, strlen (token_tests[i].slow));
+      slow = gtk_css_tokenizer_new (bytes);
+      g_bytes_unref (bytes);
+
+      do
+        {
+          char *fast_string, *slow_string;
+
+          g_assert_true (gtk_css_tokenizer_read_token (fast, &fast_token, NULL));
+          g_assert_true (gtk_css_tokenizer_read_token (slow, &slow_token, NULL));
+
+          fast_string = gtk_css_token_to_string (&fast_token);
+          slow_string = gtk_css_token_to_string (&slow_token);
+          g_assert_cmpint (fast_token.type, ==, slow_token.type);
+          g_assert_cmpstr (fast_string, ==, slow_string);
+          g_free (fast_string);
+          g_free (slow_string);
+
+          gtk_css_token_clear (&slow_token);
+          gtk_css_token_clear (&fast_token);
+          n_tokens++;
+        }
+      while (!gtk_css_token_is (&fast_token, GTK_CSS_TOKEN_EOF));
+
+      g_assert_cmpuint (n_tokens, >, 1);
+
+      gtk_css_tokenizer_unref (fast);
+      gtk_css_tokenizer_unref (slow);
+    }
+}
+
+/* Loading from data leaves the theme without a base location,
+ * so its relative asset urls will fail to resolve. Those errors
+ * are expected and ignored here.
+ */
+static void
+parsing_error_cb (GtkCssProvider *provider,
+                  GtkCssSection  *section,
+                  const GError   *error)
+{
+}
+
+/* Parses the built-in theme over and over. A new provider is used
+ * for every iteration, so that reloading identical data does not
+ * short-circuit the parser.
+ */
+static void
+test_parse_theme (void)
+{
+  guint n_iterations = g_test_perf () ? 100 : 2;
+  GBytes *bytes;
+  const char *data;
+  gsize size;
+  guint i;
+  double elapsed;
+
+  bytes = g_resources_lookup_data ("/org/gtk/libgtk/theme/Adwaita/Adwaita.css", 0, NULL);
+  g_assert_nonnull (bytes);
+  data = g_bytes_get_data (bytes, &size);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      GtkCssProvider *provider = gtk_css_provider_new ();
+
+      g_signal_connect (provider, "parsing-error", G_CALLBACK (parsing_error_cb), NULL);
+      gtk_css_provider_load_from_data (provider, data, size);
+      g_object_unref (provider);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_maximized_result (size * n_iterations / elapsed / (1024 * 1024),
+                             "parsing %u times %" G_GSIZE_FORMAT " bytes of Adwaita: %g MB/sec",
+                             n_iterations, size, size * n_iterations / elapsed / (1024 * 1024));
+
+  g_bytes_unref (bytes);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/css/parse/tokenizer", test_tokenizer_fast_paths);
+  g_test_add_func ("/css/parse/theme", test_parse_theme);
+
+  return g_test_run ();
+}
@@ -1,4 +1,5 @@
 #include <gtk/gtk.h>
+#include <string.h>
 
 static void
 assert_section_is_not_null (GtkCssProvider *provider,
@@ -33,6 +34,68 @@ test_section_load_nonexisting_file (void)
   g_object_unref (provider);
 }
 
+static void
+test_load_resource_twice (void)
+{
+  GtkCssProvider *provider1, *provider2;
+  char *s1, *s2;
+
+  provider1 = gtk_css_provider_new ();
+  gtk_css_provider_load_from_resource (provider1, "/org/gtk/libgtk/theme/Adwaita/gtk.css");
+  s1 = gtk_css_provider_to_string (provider1);
+
+  /* The second load shares the compiled stylesheet of the first */
+  provider2 = gtk_css_provider_new ();
+  gtk_css_provider_load_from_resource (provider2, "/org/gtk/libgtk/theme/Adwaita/gtk.css");
+  s2 = gtk_css_provider_to_string (provider2);
+
+  g_assert_cmpstr (s1, ==, s2);
+  g_assert_cmpuint (strlen (s1), >, 0);
+
+  /* Loading other data must not affect the shared stylesheet */
+  gtk_css_provider_load_from_data (provider1, "label { color: red; }", -1);
+  g_free (s2);
+  s2 = gtk_css_provider_to_string (provider2);
+  g_assert_cmpstr (s1, ==, s2);
+
+  g_free (s1);
+  g_free (s2);
+  g_object_unref (provider1);
+  g_object_unref (provider2);
+}
+
+static void
+count_changed (GtkStyleProvider *provider,
+               gpointer          data)
+{
+  guint *counter = data;
+
+  (*counter)++;
+}
+
+static void
+test_reload_same_data (void)
+{
+  GtkCssProvider *provider;
+  guint changed = 0;
+
+  provider = gtk_css_provider_new ();
+  g_signal_connect (provider, "gtk-private-changed",
+                    G_CALLBACK (count_changed), &changed);
+
+  gtk_css_provider_load_from_data (provider, "label { color: red; }", -1);
+  g_assert_cmpuint (changed, ==, 1);
+
+  /* Loading the same data again must not cause a restyle */
+  gtk_css_provider_load_from_data (provider, "label { color: red; }", -1);
+  g_assert_cmpuint (changed, ==, 1);
+
+  gtk_css_provider_load_from_data (provider, "label { color: blue; }", -1);
+  g_assert_cmpuint (changed, ==, 2);
+
+  g_object_unref (provider);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -41,6 +104,8 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/cssprovider/section-in-load-from-data", test_section_in_load_from_data);
   g_test_add_func ("/cssprovider/load-nonexisting-file", test_section_load_nonexisting_file);
+  g_test_add_func ("/cssprovider/load-resource-twice", test_load_resource_twice);
+  g_test_add_func ("/cssprovider/reload-same-data", test_reload_same_data);
 
   return g_test_run ();
 }
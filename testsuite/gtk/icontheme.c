@@ -789,6 +789,43 @@ test_nonsquare_symbolic (void)
   g_object_unref (info);
 }
 
+static gboolean
+sizes_contain (const int *sizes,
+               int        size)
+{
+  for (; *sizes; sizes++)
+    {
+      if (*sizes == size)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+test_icon_sizes (void)
+{
+  GtkIconTheme *icon_theme;
+  int *sizes;
+
+  icon_theme = get_test_icontheme (FALSE);
+
+  sizes = gtk_icon_theme_get_icon_sizes (icon_theme, "twosize-fixed");
+  g_assert_true (sizes_contain (sizes, 16));
+  g_assert_true (sizes_contain (sizes, 32));
+  g_assert_false (sizes_contain (sizes, -1));
+  g_free (sizes);
+
+  sizes = gtk_icon_theme_get_icon_sizes (icon_theme, "twosize");
+  g_assert_true (sizes_contain (sizes, -1));
+  g_assert_false (sizes_contain (sizes, 16));
+  g_free (sizes);
+
+  sizes = gtk_icon_theme_get_icon_sizes (icon_theme, "does-not-exist");
+  g_assert_cmpint (sizes[0], ==, 0);
+  g_free (sizes);
+}
+
 static void
 require_env (const char *var)
 {
@@ -815,6 +852,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/icontheme/list", test_list);
   g_test_add_func ("/icontheme/inherit", test_inherit);
   g_test_add_func ("/icontheme/nonsquare-symbolic", test_nonsquare_symbolic);
+  g_test_add_func ("/icontheme/icon-sizes", test_icon_sizes);
 
   return g_test_run();
 }
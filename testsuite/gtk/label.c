@@ -0,0 +1,126 @@
+#include <gtk/gtk.h>
+
+static const char text[] =
+  "This is a rather long label that needs to wrap over several lines "
+  "when it is not given enough width to show all of its text in one go.";
+
+/* Allocates a wrapping label, then measures it at a range of other
+ * widths, the way a box or list row does when doing height-for-width.
+ * Measuring must not touch the label's own layout and its line breaks.
+ */
+static void
+test_label_height_for_width (void)
+{
+  guint n_iterations = g_test_perf () ? 1000 : 2;
+  GtkWidget *label;
+  PangoLayout *layout;
+  int min_width, nat_width;
+  int min_height, nat_height;
+  int single_height, alloc_width, alloc_height, prev_height;
+  int width, n_lines;
+  guint i, n_measures = 0;
+  double elapsed;
+
+  label = gtk_label_new (text);
+  g_object_ref_sink (label);
+  gtk_label_set_wrap (GTK_LABEL (label), TRUE);
+
+  g_assert_cmpint (gtk_widget_get_request_mode (label), ==, GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH);
+
+  gtk_widget_measure (label, GTK_ORIENTATION_HORIZONTAL, -1,
+                      &min_width, &nat_width, NULL, NULL);
+  g_assert_cmpint (min_width, <=, nat_width);
+
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, nat_width,
+                      &single_height, NULL, NULL, NULL);
+
+  alloc_width = MAX (min_width, nat_width / 2);
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, alloc_width,
+                      &alloc_height, NULL, NULL, NULL);
+  gtk_widget_allocate (label, alloc_width, alloc_height, -1, NULL);
+
+  layout = gtk_label_get_layout (GTK_LABEL (label));
+  n_lines = pango_layout_get_line_count (layout);
+  g_assert_cmpint (n_lines, >, 1);
+  g_assert_cmpint (pango_layout_get_width (layout), ==, alloc_width * PANGO_SCALE);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n_iterations; i++)
+    {
+      prev_height = single_height;
+
+      for (width = nat_width; width >= min_width; width -= MAX (1, (nat_width - min_width) / 20))
+        {
+          if (width == alloc_width)
+            continue;
+
+          gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, width,
+                              &min_height, &nat_height, NULL, NULL);
+          n_measures++;
+
+          g_assert_cmpint (min_height, ==, nat_height);
+          g_assert_cmpint (min_height, >=, prev_height);
+          prev_height = min_height;
+
+          /* The label's layout keeps the allocated width and line breaks */
+          g_assert_true (gtk_label_get_layout (GTK_LABEL (label)) == layout);
+          g_assert_cmpint (pango_layout_get_width (layout), ==, alloc_width * PANGO_SCALE);
+          g_assert_cmpint (pango_layout_get_line_count (layout), ==, n_lines);
+        }
+
+      g_assert_cmpint (prev_height, >, single_height);
+
+      /* Invalidate the size request cache, but not the label */
+      gtk_widget_queue_resize (label);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_maximized_result (n_measures / elapsed, "%u height-for-width measurements: %g/sec",
+                             n_measures, n_measures / elapsed);
+
+  g_object_unref (label);
+}
+
+/* Changing the wrap mode of a label that was measured and allocated
+ * must reach the layout used for measuring and drawing.
+ */
+static void
+test_label_wrap_mode (void)
+{
+  GtkWidget *label;
+  int width, height;
+
+  label = gtk_label_new (text);
+  g_object_ref_sink (label);
+  gtk_label_set_wrap (GTK_LABEL (label), TRUE);
+
+  gtk_widget_measure (label, GTK_ORIENTATION_HORIZONTAL, -1,
+                      NULL, &width, NULL, NULL);
+  width /= 2;
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, width,
+                      &height, NULL, NULL, NULL);
+  gtk_widget_allocate (label, width, height, -1, NULL);
+  g_assert_cmpint (pango_layout_get_wrap (gtk_label_get_layout (GTK_LABEL (label))), ==, PANGO_WRAP_WORD);
+
+  gtk_label_set_wrap_mode (GTK_LABEL (label), PANGO_WRAP_CHAR);
+
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, width,
+                      &height, NULL, NULL, NULL);
+  gtk_widget_allocate (label, width, height, -1, NULL);
+  g_assert_cmpint (pango_layout_get_wrap (gtk_label_get_layout (GTK_LABEL (label))), ==, PANGO_WRAP_CHAR);
+
+  g_object_unref (label);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/label/height-for-width", test_label_height_for_width);
+  g_test_add_func ("/label/wrap-mode", test_label_wrap_mode);
+
+  return g_test_run ();
+}
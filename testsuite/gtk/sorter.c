@@ -48,6 +48,13 @@ get_string (gpointer object)
   return g_strdup_printf ("%u", GPOINTER_TO_UINT (g_object_get_qdata (object, number_quark)));
 }
 
+/* Longer than the inline key prefix of the string sorter */
+static char *
+get_long_string (gpointer object)
+{
+  return g_strdup_printf ("a rather long common prefix %u", GPOINTER_TO_UINT (g_object_get_qdata (object, number_quark)));
+}
+
 static guint
 get_number_mod_5 (GObject *object)
 {
@@ -315,6 +322,25 @@ test_string (void)
   g_object_unref (model);
 }
 
+static void
+test_string_long_prefix (void)
+{
+  GtkSortListModel *model;
+  GtkSorter *sorter;
+
+  model = new_model (20, NULL);
+  assert_not_model (model, "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20");
+
+  sorter = GTK_SORTER (gtk_string_sorter_new (gtk_cclosure_expression_new (G_TYPE_STRING, NULL, 0, NULL, (GCallback)get_long_string, NULL, NULL)));
+
+  gtk_sort_list_model_set_sorter (model, sorter);
+  g_object_unref (sorter);
+
+  assert_model (model, "1 10 11 12 13 14 15 16 17 18 19 2 20 3 4 5 6 7 8 9");
+
+  g_object_unref (model);
+}
+
 static void
 inc_counter (GtkSorter *sorter, int change, gpointer data)
 {
@@ -662,6 +688,7 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/sorter/simple", test_simple);
   g_test_add_func ("/sorter/string", test_string);
+  g_test_add_func ("/sorter/string-long-prefix", test_string_long_prefix);
   g_test_add_func ("/sorter/change", test_change);
   g_test_add_func ("/sorter/numeric", test_numeric);
   g_test_add_func ("/sorter/multi", test_multi);
@@ -1348,6 +1348,67 @@ test_tag (void)
   g_object_unref (buffer);
 }
 
+static void
+check_tag_toggles (GtkTextBuffer *buffer,
+                   GtkTextTag    *tag,
+                   const int     *offsets,
+                   int            n_offsets)
+{
+  GtkTextIter iter;
+  int i;
+
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  for (i = 0; i < n_offsets; i++)
+    {
+      g_assert_true (gtk_text_iter_forward_to_tag_toggle (&iter, tag));
+      g_assert_cmpint (gtk_text_iter_get_offset (&iter), ==, offsets[i]);
+    }
+  g_assert_false (gtk_text_iter_forward_to_tag_toggle (&iter, tag));
+}
+
+/* Applying a tag where it is already present, or removing it
+ * where it isn't, must leave the toggles alone.
+ */
+static void
+test_tag_reapply (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GtkTextTag *tag;
+  const int toggles[] = { 1, 3, 5, 8 };
+  const int merged[] = { 1, 8 };
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "abcdefghij\nklmnop", -1);
+  tag = gtk_text_buffer_create_tag (buffer, NULL, "weight", PANGO_WEIGHT_BOLD, NULL);
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 1);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end, 3);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 5);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end, 8);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+  check_tag_toggles (buffer, tag, toggles, G_N_ELEMENTS (toggles));
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 6);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end, 8);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 3);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end, 5);
+  gtk_text_buffer_remove_tag (buffer, tag, &start, &end);
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 12);
+  gtk_text_buffer_get_end_iter (buffer, &end);
+  gtk_text_buffer_remove_tag (buffer, tag, &start, &end);
+  check_tag_toggles (buffer, tag, toggles, G_N_ELEMENTS (toggles));
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 2);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end, 6);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, &end);
+  check_tag_toggles (buffer, tag, merged, G_N_ELEMENTS (merged));
+
+  g_object_unref (buffer);
+}
+
 static void
 check_buffer_contents (GtkTextBuffer *buffer,
                        const char    *contents)
@@ -1581,6 +1642,60 @@ test_get_iter (void)
   g_object_unref (buffer);
 }
 
+/* Loads a large text with all kinds of line separators in one go.
+ * In perf mode, this reports the loading throughput.
+ */
+static void
+test_load_large (void)
+{
+  static const char *lines[] = {
+    "A line of log output ending with a newline\n",
+    "A DOS line \xc3\xa4\xc3\xb6\xc3\xbc\r\n",
+    "An old Mac line\r",
+    "A line ending in a paragraph separator\xe2\x80\xa9",
+    "\n",
+  };
+  guint n_lines = g_test_perf () ? 1000000 : 1000;
+  GtkDebugFlags flags;
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GString *string;
+  char *text;
+  double elapsed;
+  guint i;
+
+  /* The btree checks would dominate the timing */
+  flags = gtk_get_debug_flags ();
+  gtk_set_debug_flags (flags & ~GTK_DEBUG_TEXT);
+
+  string = g_string_new (NULL);
+  for (i = 0; i < n_lines; i++)
+    g_string_append (string, lines[i % G_N_ELEMENTS (lines)]);
+
+  buffer = gtk_text_buffer_new (NULL);
+
+  g_test_timer_start ();
+  gtk_text_buffer_set_text (buffer, string->str, string->len);
+  elapsed = g_test_timer_elapsed ();
+
+  if (g_test_perf ())
+    g_test_maximized_result (string->len / elapsed / (1024 * 1024),
+                             "loading %u lines: %g MB/sec",
+                             n_lines, string->len / elapsed / (1024 * 1024));
+
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, n_lines + 1);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  text = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  g_assert_cmpstr (text, ==, string->str);
+  g_free (text);
+
+  g_string_free (string, TRUE);
+  g_object_unref (buffer);
+
+  gtk_set_debug_flags (flags);
+}
+
 int
 main (int argc, char** argv)
 {
@@ -1598,8 +1713,10 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Get and Set", test_get_set);
   g_test_add_func ("/TextBuffer/Fill and Empty", test_fill_empty);
   g_test_add_func ("/TextBuffer/Tag", test_tag);
+  g_test_add_func ("/TextBuffer/Reapply tag", test_tag_reapply);
   g_test_add_func ("/TextBuffer/Clipboard", test_clipboard);
   g_test_add_func ("/TextBuffer/Get iter", test_get_iter);
+  g_test_add_func ("/TextBuffer/Load large", test_load_large);
 
   return g_test_run();
 }
@@ -194,6 +194,54 @@ test_search (void)
   check_found_backward ("aa \303\200", "aa", 0, 0, 2, "aa");
 }
 
+/* Most lines don't contain the first byte of the needle, and the
+ * match is split over several segments by tags.
+ */
+static void
+test_search_skip_lines (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter i, s, e;
+  GtkTextTag *tag;
+  GString *str;
+  gboolean res;
+  char *text;
+  int n;
+
+  buffer = gtk_text_buffer_new (NULL);
+  str = g_string_new (NULL);
+  for (n = 0; n < 100; n++)
+    g_string_append (str, "abcdefghijklmnopqrstuvw\n");
+  g_string_append (str, "xyz xyz\nabc");
+  gtk_text_buffer_set_text (buffer, str->str, -1);
+
+  tag = gtk_text_buffer_create_tag (buffer, NULL, "weight", PANGO_WEIGHT_BOLD, NULL);
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &s, 100, 5);
+  gtk_text_buffer_get_iter_at_line_offset (buffer, &e, 100, 6);
+  gtk_text_buffer_apply_tag (buffer, tag, &s, &e);
+
+  gtk_text_buffer_get_start_iter (buffer, &i);
+  res = gtk_text_iter_forward_search (&i, "xyz\nab", 0, &s, &e, NULL);
+  g_assert_true (res);
+  g_assert_cmpint (gtk_text_iter_get_offset (&s), ==, 100 * 24 + 4);
+  g_assert_cmpint (gtk_text_iter_get_offset (&e), ==, 100 * 24 + 10);
+  text = gtk_text_iter_get_text (&s, &e);
+  g_assert_cmpstr (text, ==, "xyz\nab");
+  g_free (text);
+
+  gtk_text_buffer_get_start_iter (buffer, &i);
+  res = gtk_text_iter_forward_search (&i, "xy", 0, &s, &e, NULL);
+  g_assert_true (res);
+  g_assert_cmpint (gtk_text_iter_get_offset (&s), ==, 100 * 24);
+
+  gtk_text_buffer_get_start_iter (buffer, &i);
+  res = gtk_text_iter_forward_search (&i, "xz", 0, &s, &e, NULL);
+  g_assert_false (res);
+
+  g_string_free (str, TRUE);
+  g_object_unref (buffer);
+}
+
 static void
 test_search_caseless (void)
 {
@@ -788,6 +836,7 @@ main (int argc, char** argv)
   g_test_add_func ("/TextIter/Search Empty", test_empty_search);
   g_test_add_func ("/TextIter/Search Full Buffer", test_search_full_buffer);
   g_test_add_func ("/TextIter/Search", test_search);
+  g_test_add_func ("/TextIter/Search Skip Lines", test_search_skip_lines);
   g_test_add_func ("/TextIter/Search Caseless", test_search_caseless);
   g_test_add_func ("/TextIter/Forward To Tag Toggle", test_forward_to_tag_toggle);
   g_test_add_func ("/TextIter/Forward To Line End", test_forward_to_line_end);
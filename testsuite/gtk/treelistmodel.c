@@ -252,6 +252,35 @@ test_remove_some (void)
   g_object_unref (tree);
 }
 
+static void
+test_lazy_autoexpand (void)
+{
+  GtkTreeListModel *tree = new_model (100, FALSE);
+
+  gtk_tree_list_model_set_lazy_autoexpand (tree, TRUE);
+  gtk_tree_list_model_set_autoexpand (tree, TRUE);
+
+  /* Looking at rows queues them for expanding */
+  assert_model (tree, "100");
+  assert_changes (tree, "");
+
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  assert_changes (tree, "1+10");
+
+  assert_model (tree, "100 100 90 80 70 60 50 40 30 20 10");
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  assert_changes (tree, "11+10, 10+10, 9+10, 8+10, 7+10, 6+10, 5+10, 4+10, 3+10, 2+10");
+
+  assert_model (tree, "100 100 100 99 98 97 96 95 94 93 92 91 90 90 89 88 87 86 85 84 83 82 81 80 80 79 78 77 76 75 74 73 72 71 70 70 69 68 67 66 65 64 63 62 61 60 60 59 58 57 56 55 54 53 52 51 50 50 49 48 47 46 45 44 43 42 41 40 40 39 38 37 36 35 34 33 32 31 30 30 29 28 27 26 25 24 23 22 21 20 20 19 18 17 16 15 14 13 12 11 10 10 9 8 7 6 5 4 3 2 1");
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  assert_changes (tree, "");
+
+  g_object_unref (tree);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -263,6 +292,7 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/treelistmodel/expand", test_expand);
   g_test_add_func ("/treelistmodel/remove_some", test_remove_some);
+  g_test_add_func ("/treelistmodel/lazy_autoexpand", test_lazy_autoexpand);
 
   return g_test_run ();
 }